@@ -2,11 +2,21 @@
 // Copyright (c) 2019 - 2025 Intel Corporation.
 
 #include <linux/acpi.h>
+#include <linux/atomic.h>
 #include <linux/clk.h>
 #include <linux/delay.h>
+#include <linux/gpio/consumer.h>
+#include <linux/hrtimer.h>
 #include <linux/i2c.h>
+#include <linux/interrupt.h>
+#include <linux/math64.h>
 #include <linux/module.h>
+#include <linux/mutex.h>
 #include <linux/pm_runtime.h>
+#include <linux/regmap.h>
+#include <linux/spinlock.h>
+#include <linux/version.h>
+#include <linux/workqueue.h>
 
 #include <media/v4l2-cci.h>
 #include <media/v4l2-ctrls.h>
@@ -14,6 +24,10 @@
 #include <media/v4l2-device.h>
 #include <media/v4l2-fwnode.h>
 
+#include "media/sensor-regseq.h"
+
+#include "ar0234-regs.h"
+
 /* Chip ID */
 #define AR0234_REG_CHIP_ID		CCI_REG16(0x3000)
 #define AR0234_CHIP_ID			0x0a56
@@ -23,8 +37,13 @@
 #define AR0234_REG_EXPOSURE		CCI_REG16(0x3012)
 #define AR0234_REG_ANALOG_GAIN		CCI_REG16(0x3060)
 #define AR0234_REG_GLOBAL_GAIN		CCI_REG16(0x305e)
+#define AR0234_REG_GROUPED_HOLD		CCI_REG8(0x3022)
 #define AR0234_REG_ORIENTATION		CCI_REG16(0x3040)
 #define AR0234_REG_TEST_PATTERN		CCI_REG16(0x0600)
+#define AR0234_REG_SEQ_ADDR		CCI_REG16(0x3088)
+#define AR0234_REG_SEQ_DATA		0x3086
+#define AR0234_REG_GRR_CONTROL1		CCI_REG16(0x30ce)
+#define AR0234_GRR_SLAVE_MODE		BIT(8)
 
 #define AR0234_EXPOSURE_MIN		0
 #define AR0234_EXPOSURE_MAX_MARGIN	80
@@ -57,6 +76,43 @@
 #define AR0234_MODE_RESET		0x00d9
 #define AR0234_MODE_STANDBY		0x2058
 #define AR0234_MODE_STREAMING		0x205c
+/* Standby with the trigger input enabled, one frame per trigger edge */
+#define AR0234_MODE_TRIGGER		0x2158
+
+/* Software trigger pulse on the "trigger" GPIO */
+#define AR0234_TRIGGER_PULSE_US		10
+
+#define V4L2_CID_AR0234_TRIGGER_MODE		(V4L2_CID_USER_BASE | 0x1041)
+#define V4L2_CID_AR0234_TRIGGER			(V4L2_CID_USER_BASE | 0x1042)
+#define V4L2_CID_AR0234_TARGET_FRAME		(V4L2_CID_USER_BASE | 0x1043)
+#define V4L2_CID_AR0234_EST_APPLIED_FRAME	(V4L2_CID_USER_BASE | 0x1044)
+#define V4L2_CID_AR0234_EST_FRAME		(V4L2_CID_USER_BASE | 0x1045)
+#define V4L2_CID_AR0234_TRIGGER_LATENCY		(V4L2_CID_USER_BASE | 0x1046)
+
+/*
+ * Frames from a register write to the first frame showing its effect.
+ * Exposure, gains and VTS share one grouped hold, so they share the delay.
+ */
+#define AR0234_EXPOSURE_DELAY		2
+
+/* Delayed control writes pending at most, and when in a frame they go */
+#define AR0234_CTRL_QUEUE_LEN		8
+#define AR0234_CTRL_WRITE_MARGIN_US	500
+
+#define AR0234_WRITE_EXPOSURE		BIT(0)
+#define AR0234_WRITE_ANALOGUE_GAIN	BIT(1)
+#define AR0234_WRITE_DIGITAL_GAIN	BIT(2)
+#define AR0234_WRITE_VTS		BIT(3)
+#define AR0234_WRITE_HOLD		(AR0234_WRITE_EXPOSURE | \
+					 AR0234_WRITE_ANALOGUE_GAIN | \
+					 AR0234_WRITE_DIGITAL_GAIN | \
+					 AR0234_WRITE_VTS)
+
+/* Sequencer RAM words per data port burst */
+#define AR0234_SEQ_BURST_WORDS		64
+
+/* Default power/autosuspend_delay_ms, keeps the mode across short gaps */
+#define AR0234_AUTOSUSPEND_DELAY_MS	5000
 
 #define AR0234_PIXEL_RATE		128000000ULL
 #define AR0234_XCLK_FREQ		19200000ULL
@@ -69,9 +125,36 @@
 
 #define to_ar0234(_sd)	container_of(_sd, struct ar0234, sd)
 
-struct ar0234_reg_list {
-	u32 num_of_regs;
-	const struct cci_reg_sequence *regs;
+struct ar0234_seq {
+	u16 addr;
+	u32 num_words;
+	const u16 *words;
+};
+
+/* Control registers written together, on one frame */
+struct ar0234_ctrl_write {
+	u32 frame;		/* Frame to write during */
+	u32 apply;		/* First frame showing the values */
+	unsigned int mask;	/* AR0234_WRITE_* */
+	u32 exposure;
+	u32 analogue_gain;
+	u32 digital_gain;
+	u32 vts;
+};
+
+/*
+ * Frame timing estimated from the stream start and VTS. Frame base_seq
+ * started at base, earlier frames lasted prev_ns each. With a frame start
+ * interrupt the clock is re-anchored to the last frame start seen, see
+ * ar0234_frame_clock_sync(). Without one the estimate drifts from the
+ * frames the receiver counts by the sensor clock error and the stream-on
+ * latency.
+ */
+struct ar0234_frame_clock {
+	ktime_t base;
+	u32 base_seq;
+	u64 frame_ns;
+	u64 prev_ns;
 };
 
 struct ar0234_mode {
@@ -80,325 +163,55 @@ struct ar0234_mode {
 	u32 hts;
 	u32 vts_def;
 	u32 code;
+	/* Analog setup written ahead of the sequencer RAM upload */
+	const struct sensor_blob *pre_seq_regs;
+	/* Sequencer RAM image, uploaded before regs */
+	const struct ar0234_seq *seq;
 	/* Sensor register settings for this mode */
-	const struct ar0234_reg_list reg_list;
+	const struct sensor_blob *regs;
+};
+
+/*
+ * Sequencer RAM image, loaded at R0x3088 = 0x8000 through the R0x3086
+ * data port between the analog setup and the mode registers.
+ */
+static const u16 ar0234_seq_ram[] = {
+	0xc1ae, 0x327f, 0x5780, 0x272f, 0x7416, 0x7e13, 0x8000, 0x307e,
+	0xff80, 0x20c3, 0xb00e, 0x8190, 0x1643, 0x1651, 0x9d3e, 0x9545,
+	0x2209, 0x3781, 0x9016, 0x4316, 0x7f90, 0x8000, 0x387f, 0x1380,
+	0x233b, 0x7f93, 0x4502, 0x8000, 0x7fb0, 0x8d66, 0x7f90, 0x8192,
+	0x3c16, 0x357f, 0x9345, 0x0280, 0x007f, 0xb08d, 0x667f, 0x9081,
+	0x8237, 0x4502, 0x3681, 0x8044, 0x1631, 0x4374, 0x1678, 0x7b7d,
+	0x4502, 0x450a, 0x7e12, 0x8180, 0x377f, 0x1045, 0x0a0e, 0x7fd4,
+	0x8024, 0x0e82, 0x9cc2, 0xafa8, 0xaa03, 0x430d, 0x2d46, 0x4316,
+	0x5f16, 0x530d, 0x1660, 0x401e, 0x2904, 0x2984, 0x81e7, 0x816f,
+	0x1706, 0x81e7, 0x7f81, 0x5c0d, 0x5754, 0x495f, 0x5305, 0x5307,
+	0x4d2b, 0xf810, 0x164c, 0x0755, 0x562b, 0xb82b, 0x984e, 0x1129,
+	0x9460, 0x5c09, 0x5c1b, 0x4002, 0x4500, 0x4580, 0x29b6, 0x7f80,
+	0x4004, 0x7f88, 0x4109, 0x5c0b, 0x29b2, 0x4115, 0x5c03, 0x4105,
+	0x5f2b, 0x902b, 0x8081, 0x6f40, 0x1041, 0x0160, 0x29a2, 0x29a3,
+	0x5f4d, 0x1c17, 0x0281, 0xe729, 0x8345, 0x8840, 0x0f7f, 0x8a40,
+	0x2345, 0x8024, 0x4008, 0x7f88, 0x5d29, 0x9288, 0x102b, 0x0489,
+	0x165c, 0x4386, 0x170b, 0x5c03, 0x8a48, 0x4d4e, 0x2b80, 0x4c09,
+	0x4119, 0x816f, 0x4110, 0x4001, 0x6029, 0x8229, 0x8329, 0x435c,
+	0x055f, 0x4d1c, 0x81e7, 0x4502, 0x8180, 0x7f80, 0x410a, 0x9144,
+	0x1609, 0x2fc3, 0xb130, 0xc3b1, 0x0343, 0x164a, 0x0a43, 0x160b,
+	0x4316, 0x8f43, 0x1690, 0x4316, 0x7f81, 0x450a, 0x410f, 0x7f83,
+	0x5d29, 0x4488, 0x102b, 0x0453, 0x0d40, 0x2345, 0x0240, 0x087f,
+	0x8053, 0x0d89, 0x165c, 0x4586, 0x170b, 0x5c05, 0x8a60, 0x4b91,
+	0x4416, 0x09c1, 0x2ca9, 0xab30, 0x51b3, 0x3d5a, 0x7e3d, 0x7e19,
+	0x8000, 0x8b1f, 0x2a1f, 0x83a2, 0x7516, 0xad33, 0x450a, 0x7f53,
+	0x8023, 0x8c66, 0x7f13, 0x8184, 0x1481, 0x8031, 0x3d64, 0x452a,
+	0x9451, 0x9e96, 0x3d2b, 0x3d1b, 0x529f, 0x0e3d, 0x083d, 0x167e,
+	0x307e, 0x1175, 0x163e, 0x970e, 0x82b2, 0x3d7f, 0xac3e, 0x4502,
+	0x7e11, 0x7fd0, 0x8000, 0x8c66, 0x7f90, 0x8194, 0x3f44, 0x1681,
+	0x8416, 0x2c2c, 0x2c2c,
 };
 
-static const struct cci_reg_sequence mode_1280x960_10bit_2lane[] = {
-	{ CCI_REG16(0x3f4c), 0x121f },
-	{ CCI_REG16(0x3f4e), 0x121f },
-	{ CCI_REG16(0x3f50), 0x0b81 },
-	{ CCI_REG16(0x31e0), 0x0003 },
-	{ CCI_REG16(0x30b0), 0x0028 },
-	/* R0x3088 specify the sequencer RAM access address. */
-	{ CCI_REG16(0x3088), 0x8000 },
-	/* R0x3086 write the sequencer RAM. */
-	{ CCI_REG16(0x3086), 0xc1ae },
-	{ CCI_REG16(0x3086), 0x327f },
-	{ CCI_REG16(0x3086), 0x5780 },
-	{ CCI_REG16(0x3086), 0x272f },
-	{ CCI_REG16(0x3086), 0x7416 },
-	{ CCI_REG16(0x3086), 0x7e13 },
-	{ CCI_REG16(0x3086), 0x8000 },
-	{ CCI_REG16(0x3086), 0x307e },
-	{ CCI_REG16(0x3086), 0xff80 },
-	{ CCI_REG16(0x3086), 0x20c3 },
-	{ CCI_REG16(0x3086), 0xb00e },
-	{ CCI_REG16(0x3086), 0x8190 },
-	{ CCI_REG16(0x3086), 0x1643 },
-	{ CCI_REG16(0x3086), 0x1651 },
-	{ CCI_REG16(0x3086), 0x9d3e },
-	{ CCI_REG16(0x3086), 0x9545 },
-	{ CCI_REG16(0x3086), 0x2209 },
-	{ CCI_REG16(0x3086), 0x3781 },
-	{ CCI_REG16(0x3086), 0x9016 },
-	{ CCI_REG16(0x3086), 0x4316 },
-	{ CCI_REG16(0x3086), 0x7f90 },
-	{ CCI_REG16(0x3086), 0x8000 },
-	{ CCI_REG16(0x3086), 0x387f },
-	{ CCI_REG16(0x3086), 0x1380 },
-	{ CCI_REG16(0x3086), 0x233b },
-	{ CCI_REG16(0x3086), 0x7f93 },
-	{ CCI_REG16(0x3086), 0x4502 },
-	{ CCI_REG16(0x3086), 0x8000 },
-	{ CCI_REG16(0x3086), 0x7fb0 },
-	{ CCI_REG16(0x3086), 0x8d66 },
-	{ CCI_REG16(0x3086), 0x7f90 },
-	{ CCI_REG16(0x3086), 0x8192 },
-	{ CCI_REG16(0x3086), 0x3c16 },
-	{ CCI_REG16(0x3086), 0x357f },
-	{ CCI_REG16(0x3086), 0x9345 },
-	{ CCI_REG16(0x3086), 0x0280 },
-	{ CCI_REG16(0x3086), 0x007f },
-	{ CCI_REG16(0x3086), 0xb08d },
-	{ CCI_REG16(0x3086), 0x667f },
-	{ CCI_REG16(0x3086), 0x9081 },
-	{ CCI_REG16(0x3086), 0x8237 },
-	{ CCI_REG16(0x3086), 0x4502 },
-	{ CCI_REG16(0x3086), 0x3681 },
-	{ CCI_REG16(0x3086), 0x8044 },
-	{ CCI_REG16(0x3086), 0x1631 },
-	{ CCI_REG16(0x3086), 0x4374 },
-	{ CCI_REG16(0x3086), 0x1678 },
-	{ CCI_REG16(0x3086), 0x7b7d },
-	{ CCI_REG16(0x3086), 0x4502 },
-	{ CCI_REG16(0x3086), 0x450a },
-	{ CCI_REG16(0x3086), 0x7e12 },
-	{ CCI_REG16(0x3086), 0x8180 },
-	{ CCI_REG16(0x3086), 0x377f },
-	{ CCI_REG16(0x3086), 0x1045 },
-	{ CCI_REG16(0x3086), 0x0a0e },
-	{ CCI_REG16(0x3086), 0x7fd4 },
-	{ CCI_REG16(0x3086), 0x8024 },
-	{ CCI_REG16(0x3086), 0x0e82 },
-	{ CCI_REG16(0x3086), 0x9cc2 },
-	{ CCI_REG16(0x3086), 0xafa8 },
-	{ CCI_REG16(0x3086), 0xaa03 },
-	{ CCI_REG16(0x3086), 0x430d },
-	{ CCI_REG16(0x3086), 0x2d46 },
-	{ CCI_REG16(0x3086), 0x4316 },
-	{ CCI_REG16(0x3086), 0x5f16 },
-	{ CCI_REG16(0x3086), 0x530d },
-	{ CCI_REG16(0x3086), 0x1660 },
-	{ CCI_REG16(0x3086), 0x401e },
-	{ CCI_REG16(0x3086), 0x2904 },
-	{ CCI_REG16(0x3086), 0x2984 },
-	{ CCI_REG16(0x3086), 0x81e7 },
-	{ CCI_REG16(0x3086), 0x816f },
-	{ CCI_REG16(0x3086), 0x1706 },
-	{ CCI_REG16(0x3086), 0x81e7 },
-	{ CCI_REG16(0x3086), 0x7f81 },
-	{ CCI_REG16(0x3086), 0x5c0d },
-	{ CCI_REG16(0x3086), 0x5754 },
-	{ CCI_REG16(0x3086), 0x495f },
-	{ CCI_REG16(0x3086), 0x5305 },
-	{ CCI_REG16(0x3086), 0x5307 },
-	{ CCI_REG16(0x3086), 0x4d2b },
-	{ CCI_REG16(0x3086), 0xf810 },
-	{ CCI_REG16(0x3086), 0x164c },
-	{ CCI_REG16(0x3086), 0x0755 },
-	{ CCI_REG16(0x3086), 0x562b },
-	{ CCI_REG16(0x3086), 0xb82b },
-	{ CCI_REG16(0x3086), 0x984e },
-	{ CCI_REG16(0x3086), 0x1129 },
-	{ CCI_REG16(0x3086), 0x9460 },
-	{ CCI_REG16(0x3086), 0x5c09 },
-	{ CCI_REG16(0x3086), 0x5c1b },
-	{ CCI_REG16(0x3086), 0x4002 },
-	{ CCI_REG16(0x3086), 0x4500 },
-	{ CCI_REG16(0x3086), 0x4580 },
-	{ CCI_REG16(0x3086), 0x29b6 },
-	{ CCI_REG16(0x3086), 0x7f80 },
-	{ CCI_REG16(0x3086), 0x4004 },
-	{ CCI_REG16(0x3086), 0x7f88 },
-	{ CCI_REG16(0x3086), 0x4109 },
-	{ CCI_REG16(0x3086), 0x5c0b },
-	{ CCI_REG16(0x3086), 0x29b2 },
-	{ CCI_REG16(0x3086), 0x4115 },
-	{ CCI_REG16(0x3086), 0x5c03 },
-	{ CCI_REG16(0x3086), 0x4105 },
-	{ CCI_REG16(0x3086), 0x5f2b },
-	{ CCI_REG16(0x3086), 0x902b },
-	{ CCI_REG16(0x3086), 0x8081 },
-	{ CCI_REG16(0x3086), 0x6f40 },
-	{ CCI_REG16(0x3086), 0x1041 },
-	{ CCI_REG16(0x3086), 0x0160 },
-	{ CCI_REG16(0x3086), 0x29a2 },
-	{ CCI_REG16(0x3086), 0x29a3 },
-	{ CCI_REG16(0x3086), 0x5f4d },
-	{ CCI_REG16(0x3086), 0x1c17 },
-	{ CCI_REG16(0x3086), 0x0281 },
-	{ CCI_REG16(0x3086), 0xe729 },
-	{ CCI_REG16(0x3086), 0x8345 },
-	{ CCI_REG16(0x3086), 0x8840 },
-	{ CCI_REG16(0x3086), 0x0f7f },
-	{ CCI_REG16(0x3086), 0x8a40 },
-	{ CCI_REG16(0x3086), 0x2345 },
-	{ CCI_REG16(0x3086), 0x8024 },
-	{ CCI_REG16(0x3086), 0x4008 },
-	{ CCI_REG16(0x3086), 0x7f88 },
-	{ CCI_REG16(0x3086), 0x5d29 },
-	{ CCI_REG16(0x3086), 0x9288 },
-	{ CCI_REG16(0x3086), 0x102b },
-	{ CCI_REG16(0x3086), 0x0489 },
-	{ CCI_REG16(0x3086), 0x165c },
-	{ CCI_REG16(0x3086), 0x4386 },
-	{ CCI_REG16(0x3086), 0x170b },
-	{ CCI_REG16(0x3086), 0x5c03 },
-	{ CCI_REG16(0x3086), 0x8a48 },
-	{ CCI_REG16(0x3086), 0x4d4e },
-	{ CCI_REG16(0x3086), 0x2b80 },
-	{ CCI_REG16(0x3086), 0x4c09 },
-	{ CCI_REG16(0x3086), 0x4119 },
-	{ CCI_REG16(0x3086), 0x816f },
-	{ CCI_REG16(0x3086), 0x4110 },
-	{ CCI_REG16(0x3086), 0x4001 },
-	{ CCI_REG16(0x3086), 0x6029 },
-	{ CCI_REG16(0x3086), 0x8229 },
-	{ CCI_REG16(0x3086), 0x8329 },
-	{ CCI_REG16(0x3086), 0x435c },
-	{ CCI_REG16(0x3086), 0x055f },
-	{ CCI_REG16(0x3086), 0x4d1c },
-	{ CCI_REG16(0x3086), 0x81e7 },
-	{ CCI_REG16(0x3086), 0x4502 },
-	{ CCI_REG16(0x3086), 0x8180 },
-	{ CCI_REG16(0x3086), 0x7f80 },
-	{ CCI_REG16(0x3086), 0x410a },
-	{ CCI_REG16(0x3086), 0x9144 },
-	{ CCI_REG16(0x3086), 0x1609 },
-	{ CCI_REG16(0x3086), 0x2fc3 },
-	{ CCI_REG16(0x3086), 0xb130 },
-	{ CCI_REG16(0x3086), 0xc3b1 },
-	{ CCI_REG16(0x3086), 0x0343 },
-	{ CCI_REG16(0x3086), 0x164a },
-	{ CCI_REG16(0x3086), 0x0a43 },
-	{ CCI_REG16(0x3086), 0x160b },
-	{ CCI_REG16(0x3086), 0x4316 },
-	{ CCI_REG16(0x3086), 0x8f43 },
-	{ CCI_REG16(0x3086), 0x1690 },
-	{ CCI_REG16(0x3086), 0x4316 },
-	{ CCI_REG16(0x3086), 0x7f81 },
-	{ CCI_REG16(0x3086), 0x450a },
-	{ CCI_REG16(0x3086), 0x410f },
-	{ CCI_REG16(0x3086), 0x7f83 },
-	{ CCI_REG16(0x3086), 0x5d29 },
-	{ CCI_REG16(0x3086), 0x4488 },
-	{ CCI_REG16(0x3086), 0x102b },
-	{ CCI_REG16(0x3086), 0x0453 },
-	{ CCI_REG16(0x3086), 0x0d40 },
-	{ CCI_REG16(0x3086), 0x2345 },
-	{ CCI_REG16(0x3086), 0x0240 },
-	{ CCI_REG16(0x3086), 0x087f },
-	{ CCI_REG16(0x3086), 0x8053 },
-	{ CCI_REG16(0x3086), 0x0d89 },
-	{ CCI_REG16(0x3086), 0x165c },
-	{ CCI_REG16(0x3086), 0x4586 },
-	{ CCI_REG16(0x3086), 0x170b },
-	{ CCI_REG16(0x3086), 0x5c05 },
-	{ CCI_REG16(0x3086), 0x8a60 },
-	{ CCI_REG16(0x3086), 0x4b91 },
-	{ CCI_REG16(0x3086), 0x4416 },
-	{ CCI_REG16(0x3086), 0x09c1 },
-	{ CCI_REG16(0x3086), 0x2ca9 },
-	{ CCI_REG16(0x3086), 0xab30 },
-	{ CCI_REG16(0x3086), 0x51b3 },
-	{ CCI_REG16(0x3086), 0x3d5a },
-	{ CCI_REG16(0x3086), 0x7e3d },
-	{ CCI_REG16(0x3086), 0x7e19 },
-	{ CCI_REG16(0x3086), 0x8000 },
-	{ CCI_REG16(0x3086), 0x8b1f },
-	{ CCI_REG16(0x3086), 0x2a1f },
-	{ CCI_REG16(0x3086), 0x83a2 },
-	{ CCI_REG16(0x3086), 0x7516 },
-	{ CCI_REG16(0x3086), 0xad33 },
-	{ CCI_REG16(0x3086), 0x450a },
-	{ CCI_REG16(0x3086), 0x7f53 },
-	{ CCI_REG16(0x3086), 0x8023 },
-	{ CCI_REG16(0x3086), 0x8c66 },
-	{ CCI_REG16(0x3086), 0x7f13 },
-	{ CCI_REG16(0x3086), 0x8184 },
-	{ CCI_REG16(0x3086), 0x1481 },
-	{ CCI_REG16(0x3086), 0x8031 },
-	{ CCI_REG16(0x3086), 0x3d64 },
-	{ CCI_REG16(0x3086), 0x452a },
-	{ CCI_REG16(0x3086), 0x9451 },
-	{ CCI_REG16(0x3086), 0x9e96 },
-	{ CCI_REG16(0x3086), 0x3d2b },
-	{ CCI_REG16(0x3086), 0x3d1b },
-	{ CCI_REG16(0x3086), 0x529f },
-	{ CCI_REG16(0x3086), 0x0e3d },
-	{ CCI_REG16(0x3086), 0x083d },
-	{ CCI_REG16(0x3086), 0x167e },
-	{ CCI_REG16(0x3086), 0x307e },
-	{ CCI_REG16(0x3086), 0x1175 },
-	{ CCI_REG16(0x3086), 0x163e },
-	{ CCI_REG16(0x3086), 0x970e },
-	{ CCI_REG16(0x3086), 0x82b2 },
-	{ CCI_REG16(0x3086), 0x3d7f },
-	{ CCI_REG16(0x3086), 0xac3e },
-	{ CCI_REG16(0x3086), 0x4502 },
-	{ CCI_REG16(0x3086), 0x7e11 },
-	{ CCI_REG16(0x3086), 0x7fd0 },
-	{ CCI_REG16(0x3086), 0x8000 },
-	{ CCI_REG16(0x3086), 0x8c66 },
-	{ CCI_REG16(0x3086), 0x7f90 },
-	{ CCI_REG16(0x3086), 0x8194 },
-	{ CCI_REG16(0x3086), 0x3f44 },
-	{ CCI_REG16(0x3086), 0x1681 },
-	{ CCI_REG16(0x3086), 0x8416 },
-	{ CCI_REG16(0x3086), 0x2c2c },
-	{ CCI_REG16(0x3086), 0x2c2c },
-	{ CCI_REG16(0x302a), 0x0005 },
-	{ CCI_REG16(0x302c), 0x0001 },
-	{ CCI_REG16(0x302e), 0x0003 },
-	{ CCI_REG16(0x3030), 0x0032 },
-	{ CCI_REG16(0x3036), 0x000a },
-	{ CCI_REG16(0x3038), 0x0001 },
-	{ CCI_REG16(0x30b0), 0x0028 },
-	{ CCI_REG16(0x31b0), 0x0082 },
-	{ CCI_REG16(0x31b2), 0x005c },
-	{ CCI_REG16(0x31b4), 0x5248 },
-	{ CCI_REG16(0x31b6), 0x3257 },
-	{ CCI_REG16(0x31b8), 0x904b },
-	{ CCI_REG16(0x31ba), 0x030b },
-	{ CCI_REG16(0x31bc), 0x8e09 },
-	{ CCI_REG16(0x3354), 0x002b },
-	{ CCI_REG16(0x31d0), 0x0000 },
-	{ CCI_REG16(0x31ae), 0x0204 },
-	{ CCI_REG16(0x3002), 0x0080 },
-	{ CCI_REG16(0x3004), 0x0148 },
-	{ CCI_REG16(0x3006), 0x043f },
-	{ CCI_REG16(0x3008), 0x0647 },
-	{ CCI_REG16(0x3064), 0x1802 },
-	{ CCI_REG16(0x300a), 0x04c4 },
-	{ CCI_REG16(0x300c), 0x04c4 },
-	{ CCI_REG16(0x30a2), 0x0001 },
-	{ CCI_REG16(0x30a6), 0x0001 },
-	{ CCI_REG16(0x3012), 0x010c },
-	{ CCI_REG16(0x3786), 0x0006 },
-	{ CCI_REG16(0x31ae), 0x0202 },
-	{ CCI_REG16(0x3088), 0x8050 },
-	{ CCI_REG16(0x3086), 0x9237 },
-	{ CCI_REG16(0x3044), 0x0410 },
-	{ CCI_REG16(0x3094), 0x03d4 },
-	{ CCI_REG16(0x3096), 0x0280 },
-	{ CCI_REG16(0x30ba), 0x7606 },
-	{ CCI_REG16(0x30b0), 0x0028 },
-	{ CCI_REG16(0x30ba), 0x7600 },
-	{ CCI_REG16(0x30fe), 0x002a },
-	{ CCI_REG16(0x31de), 0x0410 },
-	{ CCI_REG16(0x3ed6), 0x1435 },
-	{ CCI_REG16(0x3ed8), 0x9865 },
-	{ CCI_REG16(0x3eda), 0x7698 },
-	{ CCI_REG16(0x3edc), 0x99ff },
-	{ CCI_REG16(0x3ee2), 0xbb88 },
-	{ CCI_REG16(0x3ee4), 0x8836 },
-	{ CCI_REG16(0x3ef0), 0x1cf0 },
-	{ CCI_REG16(0x3ef2), 0x0000 },
-	{ CCI_REG16(0x3ef8), 0x6166 },
-	{ CCI_REG16(0x3efa), 0x3333 },
-	{ CCI_REG16(0x3efc), 0x6634 },
-	{ CCI_REG16(0x3088), 0x81ba },
-	{ CCI_REG16(0x3086), 0x3d02 },
-	{ CCI_REG16(0x3276), 0x05dc },
-	{ CCI_REG16(0x3f00), 0x9d05 },
-	{ CCI_REG16(0x3ed2), 0xfa86 },
-	{ CCI_REG16(0x3eee), 0xa4fe },
-	{ CCI_REG16(0x3ecc), 0x6e42 },
-	{ CCI_REG16(0x3ecc), 0x0e42 },
-	{ CCI_REG16(0x3eec), 0x0c0c },
-	{ CCI_REG16(0x3ee8), 0xaae4 },
-	{ CCI_REG16(0x3ee6), 0x3363 },
-	{ CCI_REG16(0x3ee6), 0x3363 },
-	{ CCI_REG16(0x3ee8), 0xaae4 },
-	{ CCI_REG16(0x3ee8), 0xaae4 },
-	{ CCI_REG16(0x3180), 0xc24f },
-	{ CCI_REG16(0x3102), 0x5000 },
-	{ CCI_REG16(0x3060), 0x000d },
-	{ CCI_REG16(0x3ed0), 0xff44 },
-	{ CCI_REG16(0x3ed2), 0xaa86 },
-	{ CCI_REG16(0x3ed4), 0x031f },
-	{ CCI_REG16(0x3eee), 0xa4aa },
+static const struct ar0234_seq ar0234_seq_default = {
+	.addr = 0x8000,
+	.num_words = ARRAY_SIZE(ar0234_seq_ram),
+	.words = ar0234_seq_ram,
 };
 
 static const char * const ar0234_test_pattern_menu[] = {
@@ -428,10 +241,9 @@ static const struct ar0234_mode supported_modes[] = {
 		.hts = AR0234_HTS_DEFAULT,
 		.vts_def = AR0234_VTS_DEFAULT,
 		.code = MEDIA_BUS_FMT_SGRBG10_1X10,
-		.reg_list = {
-			.num_of_regs = ARRAY_SIZE(mode_1280x960_10bit_2lane),
-			.regs = mode_1280x960_10bit_2lane,
-		},
+		.pre_seq_regs = &ar0234_1280x960_10bit_2lane_pre_seq_regs,
+		.seq = &ar0234_seq_default,
+		.regs = &ar0234_1280x960_10bit_2lane_regs,
 	},
 };
 
@@ -442,76 +254,407 @@ struct ar0234 {
 
 	/* V4L2 Controls */
 	struct v4l2_ctrl *link_freq;
+	/*
+	 * Exposure cluster, latched together under grouped parameter hold.
+	 * VBLANK goes last, its change notification updates the exposure
+	 * range once the rest of the cluster is committed.
+	 */
 	struct v4l2_ctrl *exposure;
-	struct v4l2_ctrl *hblank;
+	struct v4l2_ctrl *analogue_gain;
+	struct v4l2_ctrl *digital_gain;
+	struct v4l2_ctrl *target_frame;
 	struct v4l2_ctrl *vblank;
+
+	struct v4l2_ctrl *hblank;
 	struct v4l2_ctrl *vflip;
 	struct v4l2_ctrl *hflip;
+	struct v4l2_ctrl *trigger_mode;
+	struct gpio_desc *trigger_gpio;
+	/* Trigger edge waiting for its frame start interrupt, 0 if none */
+	atomic64_t trigger_ns;
+	u32 trigger_latency_us;
+	/* Frame start interrupts since stream start, and the last one */
+	spinlock_t frame_lock;
+	u32 frame_starts;
+	ktime_t frame_start_ts;
 	struct regmap *regmap;
+	struct sensor_regseq regseq;
 	unsigned long link_freq_bitmap;
 	const struct ar0234_mode *cur_mode;
+	/* Mode programmed into the sensor, NULL until (re)programmed */
+	const struct ar0234_mode *pre_mode;
+	bool streaming;
+
+	/*
+	 * Delayed control writes. The lock serializes the writes below
+	 * against immediate ones and protects the queue and frame clock.
+	 */
+	struct mutex ctrl_queue_lock;
+	struct ar0234_ctrl_write ctrl_queue[AR0234_CTRL_QUEUE_LEN];
+	unsigned int ctrl_queue_len;
+	struct ar0234_frame_clock clock;
+	u32 applied_frame;
+	struct hrtimer ctrl_timer;
+	struct work_struct ctrl_work;
 };
 
+static u64 ar0234_frame_ns(u32 vts)
+{
+	return div_u64((u64)vts * AR0234_PPL_DEFAULT * NSEC_PER_SEC,
+		       AR0234_PIXEL_RATE);
+}
+
+/* Frame the sensor sends at @now, by the estimated frame clock */
+static u32 ar0234_frame_seq(struct ar0234 *ar0234, ktime_t now)
+{
+	const struct ar0234_frame_clock *clk = &ar0234->clock;
+	u64 delta;
+
+	if (ktime_before(now, clk->base)) {
+		delta = ktime_to_ns(ktime_sub(clk->base, now));
+		return clk->base_seq - 1 - div64_u64(delta - 1, clk->prev_ns);
+	}
+
+	delta = ktime_to_ns(ktime_sub(now, clk->base));
+
+	return clk->base_seq + div64_u64(delta, clk->frame_ns);
+}
+
+static ktime_t ar0234_frame_start(struct ar0234 *ar0234, u32 seq)
+{
+	const struct ar0234_frame_clock *clk = &ar0234->clock;
+
+	if ((s32)(seq - clk->base_seq) < 0)
+		return ktime_sub_ns(clk->base,
+				    (u64)(clk->base_seq - seq) * clk->prev_ns);
+
+	return ktime_add_ns(clk->base,
+			    (u64)(seq - clk->base_seq) * clk->frame_ns);
+}
+
+/*
+ * Re-anchor the clock to the last frame start interrupt. Frames before a
+ * pending VTS change keep the estimate, base is already past them.
+ */
+static void ar0234_frame_clock_sync(struct ar0234 *ar0234)
+{
+	struct ar0234_frame_clock *clk = &ar0234->clock;
+	ktime_t ts;
+	u32 seq;
+
+	spin_lock_irq(&ar0234->frame_lock);
+	seq = ar0234->frame_starts - 1;
+	ts = ar0234->frame_start_ts;
+	spin_unlock_irq(&ar0234->frame_lock);
+
+	if (seq == U32_MAX || (s32)(seq - clk->base_seq) < 0)
+		return;
+
+	clk->base = ts;
+	clk->base_seq = seq;
+	clk->prev_ns = clk->frame_ns;
+}
+
+static void ar0234_frame_clock_reset(struct ar0234 *ar0234, u32 vts)
+{
+	ar0234->clock.base = ktime_get();
+	ar0234->clock.base_seq = 0;
+	ar0234->clock.frame_ns = ar0234_frame_ns(vts);
+	ar0234->clock.prev_ns = ar0234->clock.frame_ns;
+}
+
+/* Called with ctrl_queue_lock held */
+static int ar0234_ctrl_write(struct ar0234 *ar0234,
+			     const struct ar0234_ctrl_write *w)
+{
+	struct sensor_regseq *seq = &ar0234->regseq;
+	struct ar0234_frame_clock *clk = &ar0234->clock;
+	int ret = 0, hold_ret = 0;
+
+	/* Grouped parameter hold, so the sensor applies all on one frame */
+	if (w->mask & AR0234_WRITE_HOLD) {
+		ret = sensor_regseq_write(seq, AR0234_REG_GROUPED_HOLD, 1,
+					  NULL);
+		if (ret)
+			return ret;
+	}
+
+	if (w->mask & AR0234_WRITE_EXPOSURE)
+		ret = sensor_regseq_write(seq, AR0234_REG_EXPOSURE,
+					  w->exposure, NULL);
+	if (!ret && (w->mask & AR0234_WRITE_ANALOGUE_GAIN))
+		ret = sensor_regseq_write(seq, AR0234_REG_ANALOG_GAIN,
+					  w->analogue_gain, NULL);
+	if (!ret && (w->mask & AR0234_WRITE_DIGITAL_GAIN))
+		ret = sensor_regseq_write(seq, AR0234_REG_GLOBAL_GAIN,
+					  w->digital_gain, NULL);
+	if (!ret && (w->mask & AR0234_WRITE_VTS))
+		ret = sensor_regseq_write(seq, AR0234_REG_VTS, w->vts, NULL);
+
+	/* Release the hold even after a failed write */
+	if (w->mask & AR0234_WRITE_HOLD)
+		hold_ret = sensor_regseq_write(seq, AR0234_REG_GROUPED_HOLD,
+					       0, NULL);
+	if (ret || hold_ret)
+		return ret ?: hold_ret;
+
+	if (w->mask & AR0234_WRITE_VTS) {
+		/* Frames from w->apply on have the new length */
+		if (ar0234->streaming) {
+			clk->base = ar0234_frame_start(ar0234, w->apply);
+			clk->base_seq = w->apply;
+			clk->prev_ns = clk->frame_ns;
+			clk->frame_ns = ar0234_frame_ns(w->vts);
+		}
+	}
+
+	ar0234->applied_frame = w->apply;
+
+	return 0;
+}
+
+/* Called with ctrl_queue_lock held */
+static void ar0234_ctrl_queue_arm(struct ar0234 *ar0234)
+{
+	unsigned int i;
+	u32 frame;
+
+	if (!ar0234->ctrl_queue_len)
+		return;
+
+	frame = ar0234->ctrl_queue[0].frame;
+	for (i = 1; i < ar0234->ctrl_queue_len; i++)
+		if ((s32)(ar0234->ctrl_queue[i].frame - frame) < 0)
+			frame = ar0234->ctrl_queue[i].frame;
+
+	hrtimer_start(&ar0234->ctrl_timer,
+		      ktime_add_us(ar0234_frame_start(ar0234, frame),
+				   AR0234_CTRL_WRITE_MARGIN_US),
+		      HRTIMER_MODE_ABS);
+}
+
+static enum hrtimer_restart ar0234_ctrl_timer(struct hrtimer *timer)
+{
+	struct ar0234 *ar0234 = container_of(timer, struct ar0234,
+					     ctrl_timer);
+
+	queue_work(system_highpri_wq, &ar0234->ctrl_work);
+
+	return HRTIMER_NORESTART;
+}
+
+/* Write the queued controls whose frame has come */
+static void ar0234_ctrl_work(struct work_struct *work)
+{
+	struct ar0234 *ar0234 = container_of(work, struct ar0234, ctrl_work);
+	struct device *dev = ar0234->sd.dev;
+	struct ar0234_ctrl_write *w;
+	unsigned int i = 0;
+	u32 now;
+	int ret;
+
+	mutex_lock(&ar0234->ctrl_queue_lock);
+
+	ar0234_frame_clock_sync(ar0234);
+	now = ar0234_frame_seq(ar0234, ktime_get());
+	while (i < ar0234->ctrl_queue_len) {
+		w = &ar0234->ctrl_queue[i];
+		if ((s32)(w->frame - now) > 0) {
+			i++;
+			continue;
+		}
+
+		if (w->frame != now)
+			dev_dbg(dev, "frame %u write late, applies on %u\n",
+				w->apply, w->apply + now - w->frame);
+		w->apply += now - w->frame;
+
+		ret = ar0234_ctrl_write(ar0234, w);
+		if (ret)
+			dev_err(dev, "delayed control write failed: %d", ret);
+
+		*w = ar0234->ctrl_queue[--ar0234->ctrl_queue_len];
+	}
+
+	ar0234_ctrl_queue_arm(ar0234);
+
+	mutex_unlock(&ar0234->ctrl_queue_lock);
+}
+
+/*
+ * Write @w now, or queue it to take effect on frame @target, 0 for none.
+ * Values that can't make that frame anymore are written right away.
+ * Estimated Applied Frame reports where the write lands.
+ */
+static int ar0234_ctrl_schedule(struct ar0234 *ar0234,
+				struct ar0234_ctrl_write *w, u32 delay,
+				u32 target)
+{
+	int ret = 0;
+	u32 now;
+
+	mutex_lock(&ar0234->ctrl_queue_lock);
+
+	/* No frame clock while stopped or in trigger mode */
+	if (!ar0234->streaming || ar0234->trigger_mode->val) {
+		w->apply = 0;
+		ret = ar0234_ctrl_write(ar0234, w);
+		goto unlock;
+	}
+
+	ar0234_frame_clock_sync(ar0234);
+	now = ar0234_frame_seq(ar0234, ktime_get());
+	w->frame = now;
+	w->apply = now + delay;
+
+	if (!target || (s32)(target - w->apply) <= 0) {
+		ret = ar0234_ctrl_write(ar0234, w);
+		goto unlock;
+	}
+
+	if (ar0234->ctrl_queue_len == AR0234_CTRL_QUEUE_LEN) {
+		ret = -EBUSY;
+		goto unlock;
+	}
+
+	w->frame = target - delay;
+	w->apply = target;
+	ar0234->ctrl_queue[ar0234->ctrl_queue_len++] = *w;
+	ar0234->applied_frame = target;
+	ar0234_ctrl_queue_arm(ar0234);
+
+unlock:
+	mutex_unlock(&ar0234->ctrl_queue_lock);
+
+	return ret;
+}
+
+/*
+ * Drop pending writes, the controls hold the values for the next start.
+ * With the queue empty the work doesn't rearm the timer.
+ */
+static void ar0234_ctrl_queue_flush(struct ar0234 *ar0234)
+{
+	mutex_lock(&ar0234->ctrl_queue_lock);
+	ar0234->ctrl_queue_len = 0;
+	mutex_unlock(&ar0234->ctrl_queue_lock);
+
+	hrtimer_cancel(&ar0234->ctrl_timer);
+	cancel_work_sync(&ar0234->ctrl_work);
+}
+
+/*
+ * Pulse the trigger input. The sensor starts exposing on the rising
+ * edge, the trace step records when the edge was driven. The frame start
+ * interrupt, if any, measures the latency from the edge.
+ */
+static int ar0234_trigger(struct ar0234 *ar0234)
+{
+	ktime_t start;
+
+	if (!ar0234->streaming || !ar0234->trigger_mode->val)
+		return -EBUSY;
+
+	start = ktime_get();
+	gpiod_set_value_cansleep(ar0234->trigger_gpio, 1);
+	atomic64_set(&ar0234->trigger_ns, ktime_to_ns(ktime_get()));
+	fsleep(AR0234_TRIGGER_PULSE_US);
+	gpiod_set_value_cansleep(ar0234->trigger_gpio, 0);
+	sensor_regseq_trace_step(&ar0234->regseq, "trigger", start, 0);
+
+	return 0;
+}
+
+/*
+ * Frame start interrupt, wired by firmware to a sensor output. Counts the
+ * frames for the frame clock, and reports the time from the last trigger
+ * edge to the start of the frame it produced, as the "trigger-latency"
+ * trace step and the Trigger Latency control.
+ */
+static irqreturn_t ar0234_frame_irq(int irq, void *data)
+{
+	struct ar0234 *ar0234 = data;
+	ktime_t now = ktime_get();
+	unsigned long flags;
+	s64 edge;
+
+	spin_lock_irqsave(&ar0234->frame_lock, flags);
+	ar0234->frame_starts++;
+	ar0234->frame_start_ts = now;
+	spin_unlock_irqrestore(&ar0234->frame_lock, flags);
+
+	edge = atomic64_xchg(&ar0234->trigger_ns, 0);
+	if (!edge)
+		return IRQ_HANDLED;
+
+	WRITE_ONCE(ar0234->trigger_latency_us,
+		   ktime_us_delta(now, ns_to_ktime(edge)));
+	sensor_regseq_trace_step(&ar0234->regseq, "trigger-latency",
+				 ns_to_ktime(edge), 0);
+
+	return IRQ_HANDLED;
+}
+
+/*
+ * Write the changed exposure cluster controls, latched on one frame. A
+ * VBLANK set in the same VIDIOC_S_EXT_CTRLS call goes in the same hold,
+ * a Target Frame set in it schedules them and is used up with them.
+ */
+static int ar0234_write_exposure(struct ar0234 *ar0234)
+{
+	struct ar0234_ctrl_write w = {
+		.exposure = ar0234->exposure->val,
+		.analogue_gain = ar0234->analogue_gain->val,
+		.digital_gain = ar0234->digital_gain->val,
+		.vts = ar0234->cur_mode->height + ar0234->vblank->val,
+	};
+
+	if (ar0234->exposure->is_new)
+		w.mask |= AR0234_WRITE_EXPOSURE;
+	if (ar0234->analogue_gain->is_new)
+		w.mask |= AR0234_WRITE_ANALOGUE_GAIN;
+	if (ar0234->digital_gain->is_new)
+		w.mask |= AR0234_WRITE_DIGITAL_GAIN;
+	if (ar0234->vblank->is_new)
+		w.mask |= AR0234_WRITE_VTS;
+	if (!w.mask)
+		return 0;
+
+	return ar0234_ctrl_schedule(ar0234, &w, AR0234_EXPOSURE_DELAY,
+				    ar0234->target_frame->is_new ?
+				    ar0234->target_frame->val : 0);
+}
+
 static int ar0234_set_ctrl(struct v4l2_ctrl *ctrl)
 {
 	struct ar0234 *ar0234 =
 		container_of(ctrl->handler, struct ar0234, ctrl_handler);
 	struct i2c_client *client = v4l2_get_subdevdata(&ar0234->sd);
-	s64 exposure_max, exposure_def;
-	struct v4l2_subdev_state *state;
-	const struct v4l2_mbus_framefmt *format;
+	struct sensor_regseq *seq = &ar0234->regseq;
+	enum sensor_regseq_phase phase;
 	int ret;
 
-	state = v4l2_subdev_get_locked_active_state(&ar0234->sd);
-	format = v4l2_subdev_state_get_format(state, 0);
-
-	/* Propagate change of current control to all related controls */
-	if (ctrl->id == V4L2_CID_VBLANK) {
-		/* Update max exposure while meeting expected vblanking */
-		exposure_max = format->height + ctrl->val -
-			       AR0234_EXPOSURE_MAX_MARGIN;
-		exposure_def = format->height - AR0234_EXPOSURE_MAX_MARGIN;
-		ret = __v4l2_ctrl_modify_range(ar0234->exposure,
-					 ar0234->exposure->minimum,
-					 exposure_max, ar0234->exposure->step,
-					 exposure_def);
-		if (ret) {
-			dev_err(&client->dev, "Exposure ctrl range update failed");
-			return ret;
-		}
-	}
+	/* Drives a GPIO only, but fails unless streaming in trigger mode */
+	if (ctrl->id == V4L2_CID_AR0234_TRIGGER)
+		return ar0234_trigger(ar0234);
 
 	/* V4L2 controls values will be applied only when power is already up */
 	if (!pm_runtime_get_if_in_use(&client->dev))
 		return 0;
 
-	switch (ctrl->id) {
-	case V4L2_CID_ANALOGUE_GAIN:
-		ret = cci_write(ar0234->regmap, AR0234_REG_ANALOG_GAIN,
-				ctrl->val, NULL);
-		break;
-
-	case V4L2_CID_DIGITAL_GAIN:
-		ret = cci_write(ar0234->regmap, AR0234_REG_GLOBAL_GAIN,
-				ctrl->val, NULL);
-		break;
+	phase = sensor_regseq_set_phase(seq, SENSOR_REGSEQ_PHASE_CTRL);
 
+	switch (ctrl->id) {
 	case V4L2_CID_EXPOSURE:
-		ret = cci_write(ar0234->regmap, AR0234_REG_EXPOSURE,
-				ctrl->val, NULL);
-		break;
-
-	case V4L2_CID_VBLANK:
-		ret = cci_write(ar0234->regmap, AR0234_REG_VTS,
-				ar0234->cur_mode->height + ctrl->val, NULL);
+		ret = ar0234_write_exposure(ar0234);
 		break;
 
 	case V4L2_CID_HFLIP:
 	case V4L2_CID_VFLIP:
 		u64 reg;
 
-		ret = cci_read(ar0234->regmap, AR0234_REG_ORIENTATION,
-			       &reg, NULL);
+		ret = sensor_regseq_read(seq, AR0234_REG_ORIENTATION, &reg,
+					 NULL);
 		if (ret)
 			break;
 
@@ -522,13 +665,30 @@ static int ar0234_set_ctrl(struct v4l2_ctrl *ctrl)
 		if (ar0234->vflip->val)
 			reg |= AR0234_ORIENTATION_VFLIP;
 
-		ret = cci_write(ar0234->regmap, AR0234_REG_ORIENTATION,
-				reg, NULL);
+		ret = sensor_regseq_write(seq, AR0234_REG_ORIENTATION,
+					  reg, NULL);
 		break;
 
 	case V4L2_CID_TEST_PATTERN:
-		ret = cci_write(ar0234->regmap, AR0234_REG_TEST_PATTERN,
-				ar0234_test_pattern_val[ctrl->val], NULL);
+		ret = sensor_regseq_write(seq, AR0234_REG_TEST_PATTERN,
+					  ar0234_test_pattern_val[ctrl->val],
+					  NULL);
+		break;
+
+	case V4L2_CID_AR0234_TRIGGER_MODE:
+		u64 grr;
+
+		ret = sensor_regseq_read(seq, AR0234_REG_GRR_CONTROL1, &grr,
+					 NULL);
+		if (ret)
+			break;
+
+		grr &= ~AR0234_GRR_SLAVE_MODE;
+		if (ctrl->val)
+			grr |= AR0234_GRR_SLAVE_MODE;
+
+		ret = sensor_regseq_write(seq, AR0234_REG_GRR_CONTROL1, grr,
+					  NULL);
 		break;
 
 	default:
@@ -536,15 +696,142 @@ static int ar0234_set_ctrl(struct v4l2_ctrl *ctrl)
 		break;
 	}
 
+	sensor_regseq_set_phase(seq, phase);
 	pm_runtime_put(&client->dev);
 
 	return ret;
 }
 
+/*
+ * Update max exposure while meeting expected vblanking. Called once the
+ * exposure cluster is committed, with the control handler lock held.
+ */
+static void ar0234_vblank_notify(struct v4l2_ctrl *ctrl, void *priv)
+{
+	struct ar0234 *ar0234 = priv;
+	struct i2c_client *client = v4l2_get_subdevdata(&ar0234->sd);
+	const struct v4l2_mbus_framefmt *format;
+	struct v4l2_subdev_state *state;
+	s64 exposure_max, exposure_def;
+
+	state = v4l2_subdev_get_locked_active_state(&ar0234->sd);
+	format = v4l2_subdev_state_get_format(state, 0);
+
+	exposure_max = format->height + ctrl->val - AR0234_EXPOSURE_MAX_MARGIN;
+	exposure_def = format->height - AR0234_EXPOSURE_MAX_MARGIN;
+	if (__v4l2_ctrl_modify_range(ar0234->exposure,
+				     ar0234->exposure->minimum, exposure_max,
+				     ar0234->exposure->step, exposure_def))
+		dev_err(&client->dev, "Exposure ctrl range update failed");
+}
+
+static int ar0234_get_volatile_ctrl(struct v4l2_ctrl *ctrl)
+{
+	struct ar0234 *ar0234 =
+		container_of(ctrl->handler, struct ar0234, ctrl_handler);
+
+	mutex_lock(&ar0234->ctrl_queue_lock);
+
+	switch (ctrl->id) {
+	case V4L2_CID_AR0234_EST_APPLIED_FRAME:
+		ctrl->val = ar0234->applied_frame;
+		break;
+
+	case V4L2_CID_AR0234_EST_FRAME:
+		if (ar0234->streaming) {
+			ar0234_frame_clock_sync(ar0234);
+			ctrl->val = ar0234_frame_seq(ar0234, ktime_get());
+		} else {
+			ctrl->val = 0;
+		}
+		break;
+
+	case V4L2_CID_AR0234_TRIGGER_LATENCY:
+		ctrl->val = READ_ONCE(ar0234->trigger_latency_us);
+		break;
+	}
+
+	mutex_unlock(&ar0234->ctrl_queue_lock);
+
+	return 0;
+}
+
 static const struct v4l2_ctrl_ops ar0234_ctrl_ops = {
+	.g_volatile_ctrl = ar0234_get_volatile_ctrl,
 	.s_ctrl = ar0234_set_ctrl,
 };
 
+static const struct v4l2_ctrl_config ar0234_trigger_mode_ctrl = {
+	.ops = &ar0234_ctrl_ops,
+	.id = V4L2_CID_AR0234_TRIGGER_MODE,
+	.name = "Trigger Mode",
+	.type = V4L2_CTRL_TYPE_BOOLEAN,
+	.max = 1,
+	.step = 1,
+};
+
+static const struct v4l2_ctrl_config ar0234_trigger_ctrl = {
+	.ops = &ar0234_ctrl_ops,
+	.id = V4L2_CID_AR0234_TRIGGER,
+	.name = "Software Trigger",
+	.type = V4L2_CTRL_TYPE_BUTTON,
+	.flags = V4L2_CTRL_FLAG_EXECUTE_ON_WRITE,
+};
+
+/* Last software trigger edge to frame start interrupt, in us */
+static const struct v4l2_ctrl_config ar0234_trigger_latency_ctrl = {
+	.ops = &ar0234_ctrl_ops,
+	.id = V4L2_CID_AR0234_TRIGGER_LATENCY,
+	.name = "Trigger Latency",
+	.type = V4L2_CTRL_TYPE_INTEGER,
+	.flags = V4L2_CTRL_FLAG_READ_ONLY | V4L2_CTRL_FLAG_VOLATILE,
+	.max = S32_MAX,
+	.step = 1,
+};
+
+/*
+ * Frame sequence, counted from 0 at stream start, that the exposure, gain
+ * and VBLANK changes set in the same VIDIOC_S_EXT_CTRLS call should take
+ * effect on; 0 applies immediately. It only applies to that call and is
+ * reset at stream start. Frames are counted on the frame start interrupt
+ * if firmware provides one, else on the estimated frame clock. Neither
+ * follows the sequence numbers the receiver reports, so keep a margin of
+ * a frame or two.
+ */
+static const struct v4l2_ctrl_config ar0234_target_frame_ctrl = {
+	.ops = &ar0234_ctrl_ops,
+	.id = V4L2_CID_AR0234_TARGET_FRAME,
+	.name = "Target Frame",
+	.type = V4L2_CTRL_TYPE_INTEGER,
+	.max = S32_MAX,
+	.step = 1,
+};
+
+/*
+ * First frame showing the last exposure, gain or VBLANK change, estimated
+ * like the Target Frame
+ */
+static const struct v4l2_ctrl_config ar0234_applied_frame_ctrl = {
+	.ops = &ar0234_ctrl_ops,
+	.id = V4L2_CID_AR0234_EST_APPLIED_FRAME,
+	.name = "Estimated Applied Frame",
+	.type = V4L2_CTRL_TYPE_INTEGER,
+	.flags = V4L2_CTRL_FLAG_READ_ONLY | V4L2_CTRL_FLAG_VOLATILE,
+	.max = S32_MAX,
+	.step = 1,
+};
+
+/* Frame the sensor is sending now, counted like the Target Frame */
+static const struct v4l2_ctrl_config ar0234_frame_ctrl = {
+	.ops = &ar0234_ctrl_ops,
+	.id = V4L2_CID_AR0234_EST_FRAME,
+	.name = "Estimated Frame Sequence",
+	.type = V4L2_CTRL_TYPE_INTEGER,
+	.flags = V4L2_CTRL_FLAG_READ_ONLY | V4L2_CTRL_FLAG_VOLATILE,
+	.max = S32_MAX,
+	.step = 1,
+};
+
 static int ar0234_init_controls(struct ar0234 *ar0234)
 {
 	struct i2c_client *client = v4l2_get_subdevdata(&ar0234->sd);
@@ -555,7 +842,7 @@ static int ar0234_init_controls(struct ar0234 *ar0234)
 	int ret;
 
 	ctrl_hdlr = &ar0234->ctrl_handler;
-	ret = v4l2_ctrl_handler_init(ctrl_hdlr, 10);
+	ret = v4l2_ctrl_handler_init(ctrl_hdlr, 15);
 	if (ret)
 		return ret;
 
@@ -568,12 +855,18 @@ static int ar0234_init_controls(struct ar0234 *ar0234)
 	if (ar0234->link_freq)
 		ar0234->link_freq->flags |= V4L2_CTRL_FLAG_READ_ONLY;
 
-	v4l2_ctrl_new_std(ctrl_hdlr, &ar0234_ctrl_ops, V4L2_CID_ANALOGUE_GAIN,
-			  AR0234_ANALOG_GAIN_MIN, AR0234_ANALOG_GAIN_MAX,
-			  AR0234_ANALOG_GAIN_STEP, AR0234_ANALOG_GAIN_DEFAULT);
-	v4l2_ctrl_new_std(ctrl_hdlr, &ar0234_ctrl_ops, V4L2_CID_DIGITAL_GAIN,
-			  AR0234_GLOBAL_GAIN_MIN, AR0234_GLOBAL_GAIN_MAX,
-			  AR0234_GLOBAL_GAIN_STEP, AR0234_GLOBAL_GAIN_DEFAULT);
+	ar0234->analogue_gain =
+		v4l2_ctrl_new_std(ctrl_hdlr, &ar0234_ctrl_ops,
+				  V4L2_CID_ANALOGUE_GAIN,
+				  AR0234_ANALOG_GAIN_MIN, AR0234_ANALOG_GAIN_MAX,
+				  AR0234_ANALOG_GAIN_STEP,
+				  AR0234_ANALOG_GAIN_DEFAULT);
+	ar0234->digital_gain =
+		v4l2_ctrl_new_std(ctrl_hdlr, &ar0234_ctrl_ops,
+				  V4L2_CID_DIGITAL_GAIN,
+				  AR0234_GLOBAL_GAIN_MIN, AR0234_GLOBAL_GAIN_MAX,
+				  AR0234_GLOBAL_GAIN_STEP,
+				  AR0234_GLOBAL_GAIN_DEFAULT);
 
 	exposure_max = ar0234->cur_mode->vts_def - AR0234_EXPOSURE_MAX_MARGIN;
 	ar0234->exposure = v4l2_ctrl_new_std(ctrl_hdlr, &ar0234_ctrl_ops,
@@ -608,9 +901,29 @@ static int ar0234_init_controls(struct ar0234 *ar0234)
 				     ARRAY_SIZE(ar0234_test_pattern_menu) - 1,
 				     0, 0, ar0234_test_pattern_menu);
 
+	/* Free running by default, one frame per trigger edge when set */
+	ar0234->trigger_mode = v4l2_ctrl_new_custom(ctrl_hdlr,
+						    &ar0234_trigger_mode_ctrl,
+						    NULL);
+	if (ar0234->trigger_gpio)
+		v4l2_ctrl_new_custom(ctrl_hdlr, &ar0234_trigger_ctrl, NULL);
+	if (ar0234->trigger_gpio && client->irq > 0)
+		v4l2_ctrl_new_custom(ctrl_hdlr, &ar0234_trigger_latency_ctrl,
+				     NULL);
+
+	ar0234->target_frame = v4l2_ctrl_new_custom(ctrl_hdlr,
+						    &ar0234_target_frame_ctrl,
+						    NULL);
+	v4l2_ctrl_new_custom(ctrl_hdlr, &ar0234_applied_frame_ctrl, NULL);
+	v4l2_ctrl_new_custom(ctrl_hdlr, &ar0234_frame_ctrl, NULL);
+
 	if (ctrl_hdlr->error)
 		return ctrl_hdlr->error;
 
+	/* Exposure is the master, see ar0234_write_exposure() */
+	v4l2_ctrl_cluster(5, &ar0234->exposure);
+	v4l2_ctrl_notify(ar0234->vblank, ar0234_vblank_notify, ar0234);
+
 	ret = v4l2_fwnode_device_parse(&client->dev, &props);
 	if (ret)
 		return ret;
@@ -634,51 +947,154 @@ static void ar0234_update_pad_format(const struct ar0234_mode *mode,
 	fmt->field = V4L2_FIELD_NONE;
 }
 
+/*
+ * R0x3086 is the sequencer RAM data port: within a burst the sensor does
+ * not advance the register address but the RAM pointer set in R0x3088.
+ * Stream the whole image through it in a few large writes.
+ */
+static int ar0234_load_seq(struct ar0234 *ar0234, const struct ar0234_seq *seq)
+{
+	__be16 buf[AR0234_SEQ_BURST_WORDS];
+	u32 i, j, n;
+	int ret;
+
+	ret = sensor_regseq_write(&ar0234->regseq, AR0234_REG_SEQ_ADDR,
+				  seq->addr, NULL);
+	if (ret)
+		return ret;
+
+	for (i = 0; i < seq->num_words; i += n) {
+		n = min_t(u32, seq->num_words - i, AR0234_SEQ_BURST_WORDS);
+		for (j = 0; j < n; j++)
+			buf[j] = cpu_to_be16(seq->words[i + j]);
+
+		ret = sensor_regseq_raw_write(&ar0234->regseq,
+					      AR0234_REG_SEQ_DATA,
+					      buf, n * sizeof(*buf));
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
+/*
+ * Program cur_mode: reset the sensor and load the sequencer and the full
+ * register list.
+ */
+static int ar0234_program_mode(struct ar0234 *ar0234)
+{
+	const struct ar0234_mode *mode = ar0234->cur_mode;
+	ktime_t start;
+	int ret;
+
+	/*
+	 * Setting 0x301A.bit[0] will initiate a reset sequence:
+	 * the frame being generated will be truncated.
+	 */
+	start = ktime_get();
+	ret = sensor_regseq_write(&ar0234->regseq, AR0234_REG_MODE_SELECT,
+				  AR0234_MODE_RESET, NULL);
+	if (!ret)
+		usleep_range(1000, 1500);
+	sensor_regseq_trace_step(&ar0234->regseq, "reset", start, ret);
+	if (ret)
+		return ret;
+
+	/* Vendor order: analog setup, sequencer RAM, then the mode table */
+	start = ktime_get();
+	ret = sensor_regseq_write_blob(&ar0234->regseq, mode->pre_seq_regs,
+				       NULL);
+	sensor_regseq_trace_step(&ar0234->regseq, "table-load", start, ret);
+	if (ret)
+		return ret;
+
+	start = ktime_get();
+	ret = ar0234_load_seq(ar0234, mode->seq);
+	sensor_regseq_trace_step(&ar0234->regseq, "seq-load", start, ret);
+	if (ret)
+		return ret;
+
+	start = ktime_get();
+	ret = sensor_regseq_write_blob(&ar0234->regseq, mode->regs, NULL);
+	sensor_regseq_trace_step(&ar0234->regseq, "table-load", start, ret);
+
+	return ret;
+}
+
 static int ar0234_start_streaming(struct ar0234 *ar0234)
 {
 	struct i2c_client *client = v4l2_get_subdevdata(&ar0234->sd);
-	const struct ar0234_reg_list *reg_list;
+	enum sensor_regseq_phase phase;
+	ktime_t begin, start;
 	int ret;
 
+	begin = ktime_get();
 	ret = pm_runtime_resume_and_get(&client->dev);
 	if (ret < 0)
 		return ret;
 
 	/*
-	 * Setting 0x301A.bit[0] will initiate a reset sequence:
-	 * the frame being generated will be truncated.
+	 * The sensor keeps its registers in standby, so the mode is only
+	 * reprogrammed on a mode change or after the sensor was powered
+	 * down (see ar0234_runtime_suspend()).
 	 */
-	ret = cci_write(ar0234->regmap, AR0234_REG_MODE_SELECT,
-			AR0234_MODE_RESET, NULL);
-	if (ret) {
-		dev_err(&client->dev, "failed to reset");
-		goto err_rpm_put;
-	}
+	if (ar0234->pre_mode != ar0234->cur_mode) {
+		phase = sensor_regseq_set_phase(&ar0234->regseq,
+						SENSOR_REGSEQ_PHASE_MODE);
+		start = ktime_get();
+		ret = ar0234_program_mode(ar0234);
+		sensor_regseq_trace_step(&ar0234->regseq, "mode-set", start,
+					 ret);
+		sensor_regseq_set_phase(&ar0234->regseq, phase);
+		if (ret) {
+			dev_err(&client->dev, "failed to set mode");
+			goto err_rpm_put;
+		}
 
-	usleep_range(1000, 1500);
+		ar0234->pre_mode = ar0234->cur_mode;
+	}
 
-	reg_list = &ar0234->cur_mode->reg_list;
-	ret = cci_multi_reg_write(ar0234->regmap, reg_list->regs,
-				  reg_list->num_of_regs, NULL);
-	if (ret) {
-		dev_err(&client->dev, "failed to set mode");
+	/* Frame numbers restart, a target from the last stream is stale */
+	ret = __v4l2_ctrl_s_ctrl(ar0234->target_frame, 0);
+	if (ret)
 		goto err_rpm_put;
-	}
 
+	start = ktime_get();
 	ret = __v4l2_ctrl_handler_setup(ar0234->sd.ctrl_handler);
+	sensor_regseq_trace_step(&ar0234->regseq, "ctrl-setup", start, ret);
 	if (ret)
 		goto err_rpm_put;
 
-	ret = cci_write(ar0234->regmap, AR0234_REG_MODE_SELECT,
-			AR0234_MODE_STREAMING, NULL);
+	spin_lock_irq(&ar0234->frame_lock);
+	ar0234->frame_starts = 0;
+	spin_unlock_irq(&ar0234->frame_lock);
+
+	phase = sensor_regseq_set_phase(&ar0234->regseq,
+					SENSOR_REGSEQ_PHASE_STREAM_ON);
+	ret = sensor_regseq_write(&ar0234->regseq, AR0234_REG_MODE_SELECT,
+				  ar0234->trigger_mode->val ?
+				  AR0234_MODE_TRIGGER : AR0234_MODE_STREAMING,
+				  NULL);
+	sensor_regseq_set_phase(&ar0234->regseq, phase);
 	if (ret) {
 		dev_err(&client->dev, "failed to start stream");
 		goto err_rpm_put;
 	}
 
+	mutex_lock(&ar0234->ctrl_queue_lock);
+	ar0234_frame_clock_reset(ar0234, ar0234->cur_mode->height +
+				 ar0234->vblank->val);
+	ar0234->applied_frame = 0;
+	mutex_unlock(&ar0234->ctrl_queue_lock);
+
+	sensor_regseq_trace_step(&ar0234->regseq, "stream-on", begin, 0);
+
 	return 0;
 
 err_rpm_put:
+	sensor_regseq_trace_step(&ar0234->regseq, "stream-on", begin, ret);
+	ar0234->pre_mode = NULL;
 	pm_runtime_put(&client->dev);
 	return ret;
 }
@@ -688,12 +1104,15 @@ static int ar0234_stop_streaming(struct ar0234 *ar0234)
 	int ret;
 	struct i2c_client *client = v4l2_get_subdevdata(&ar0234->sd);
 
-	ret = cci_write(ar0234->regmap, AR0234_REG_MODE_SELECT,
-			AR0234_MODE_STANDBY, NULL);
+	ar0234_ctrl_queue_flush(ar0234);
+
+	ret = sensor_regseq_write(&ar0234->regseq, AR0234_REG_MODE_SELECT,
+				  AR0234_MODE_STANDBY, NULL);
 	if (ret < 0)
 		dev_err(&client->dev, "failed to stop stream");
 
-	pm_runtime_put(&client->dev);
+	pm_runtime_mark_last_busy(&client->dev);
+	pm_runtime_put_autosuspend(&client->dev);
 	return ret;
 }
 
@@ -709,10 +1128,12 @@ static int ar0234_set_stream(struct v4l2_subdev *sd, int enable)
 		ret = ar0234_start_streaming(ar0234);
 	else
 		ret = ar0234_stop_streaming(ar0234);
+	ar0234->streaming = enable && !ret;
 
-	/* vflip and hflip cannot change during streaming */
+	/* vflip, hflip and the trigger mode cannot change during streaming */
 	__v4l2_ctrl_grab(ar0234->vflip, enable);
 	__v4l2_ctrl_grab(ar0234->hflip, enable);
+	__v4l2_ctrl_grab(ar0234->trigger_mode, enable);
 	v4l2_subdev_unlock_state(state);
 
 	return ret;
@@ -932,7 +1353,8 @@ static int ar0234_identify_module(struct ar0234 *ar0234)
 	int ret;
 	u64 val;
 
-	ret = cci_read(ar0234->regmap, AR0234_REG_CHIP_ID, &val, NULL);
+	ret = sensor_regseq_read(&ar0234->regseq, AR0234_REG_CHIP_ID, &val,
+				 NULL);
 	if (ret)
 		return ret;
 
@@ -951,9 +1373,11 @@ static void ar0234_remove(struct i2c_client *client)
 	struct ar0234 *ar0234 = to_ar0234(sd);
 
 	v4l2_async_unregister_subdev(&ar0234->sd);
+	ar0234_ctrl_queue_flush(ar0234);
 	v4l2_subdev_cleanup(sd);
 	media_entity_cleanup(&ar0234->sd.entity);
 	v4l2_ctrl_handler_free(&ar0234->ctrl_handler);
+	pm_runtime_dont_use_autosuspend(&client->dev);
 	pm_runtime_disable(&client->dev);
 	pm_runtime_set_suspended(&client->dev);
 }
@@ -978,6 +1402,23 @@ static int ar0234_probe(struct i2c_client *client)
 	if (IS_ERR(ar0234->regmap))
 		return dev_err_probe(dev, PTR_ERR(ar0234->regmap),
 				     "failed to init CCI");
+	sensor_regseq_init(&ar0234->regseq, dev, ar0234->regmap);
+	ret = sensor_regseq_debugfs_init(&ar0234->regseq);
+	if (ret)
+		return ret;
+
+	ret = devm_mutex_init(dev, &ar0234->ctrl_queue_lock);
+	if (ret)
+		return ret;
+#if LINUX_VERSION_CODE < KERNEL_VERSION(6, 13, 0)
+	hrtimer_init(&ar0234->ctrl_timer, CLOCK_MONOTONIC, HRTIMER_MODE_ABS);
+	ar0234->ctrl_timer.function = ar0234_ctrl_timer;
+#else
+	hrtimer_setup(&ar0234->ctrl_timer, ar0234_ctrl_timer, CLOCK_MONOTONIC,
+		      HRTIMER_MODE_ABS);
+#endif
+	INIT_WORK(&ar0234->ctrl_work, ar0234_ctrl_work);
+	spin_lock_init(&ar0234->frame_lock);
 
 	v4l2_i2c_subdev_init(&ar0234->sd, client, &ar0234_subdev_ops);
 
@@ -1001,6 +1442,27 @@ static int ar0234_probe(struct i2c_client *client)
 		return ret;
 	}
 
+	/* Optional, drives the trigger input for software triggers */
+	ar0234->trigger_gpio = devm_gpiod_get_optional(dev, "trigger",
+						       GPIOD_OUT_LOW);
+	if (IS_ERR(ar0234->trigger_gpio))
+		return dev_err_probe(dev, PTR_ERR(ar0234->trigger_gpio),
+				     "failed to get trigger gpio");
+
+	/*
+	 * Optional frame start interrupt, to time software triggers. It may
+	 * come through a GPIO expander or deserializer that sleeps.
+	 */
+	if (client->irq > 0) {
+		ret = devm_request_any_context_irq(dev, client->irq,
+						   ar0234_frame_irq, 0,
+						   dev_name(dev), ar0234);
+		if (ret < 0)
+			return dev_err_probe(dev, ret,
+					     "failed to request irq %d",
+					     client->irq);
+	}
+
 	ar0234->cur_mode = &supported_modes[0];
 	ret = ar0234_init_controls(ar0234);
 	if (ret) {
@@ -1030,9 +1492,13 @@ static int ar0234_probe(struct i2c_client *client)
 
 	/*
 	 * Device is already turned on by i2c-core with ACPI domain PM.
-	 * Enable runtime PM and turn off the device.
+	 * Enable runtime PM and turn off the device once the autosuspend
+	 * delay expired. Powered up, the sensor keeps the programmed mode.
 	 */
 	pm_runtime_set_active(&client->dev);
+	pm_runtime_set_autosuspend_delay(&client->dev,
+					 AR0234_AUTOSUSPEND_DELAY_MS);
+	pm_runtime_use_autosuspend(&client->dev);
 	pm_runtime_enable(&client->dev);
 	pm_runtime_idle(&client->dev);
 
@@ -1043,8 +1509,11 @@ static int ar0234_probe(struct i2c_client *client)
 		goto probe_error_rpm;
 	}
 
+	sensor_regseq_set_phase(&ar0234->regseq, SENSOR_REGSEQ_PHASE_OTHER);
+
 	return 0;
 probe_error_rpm:
+	pm_runtime_dont_use_autosuspend(&client->dev);
 	pm_runtime_disable(&client->dev);
 	v4l2_subdev_cleanup(&ar0234->sd);
 
@@ -1057,6 +1526,20 @@ probe_error_v4l2_ctrl_handler_free:
 	return ret;
 }
 
+static int ar0234_runtime_suspend(struct device *dev)
+{
+	struct ar0234 *ar0234 = to_ar0234(dev_get_drvdata(dev));
+
+	/* The power domain may cut power, force a full reload on next start */
+	ar0234->pre_mode = NULL;
+
+	return 0;
+}
+
+static const struct dev_pm_ops ar0234_pm_ops = {
+	SET_RUNTIME_PM_OPS(ar0234_runtime_suspend, NULL, NULL)
+};
+
 static const struct acpi_device_id ar0234_acpi_ids[] = {
 	{ "INTC10C0" },
 	{}
@@ -1067,6 +1550,7 @@ static struct i2c_driver ar0234_i2c_driver = {
 	.driver = {
 		.name = "ar0234",
 		.acpi_match_table = ACPI_PTR(ar0234_acpi_ids),
+		.pm = &ar0234_pm_ops,
 	},
 	.probe = ar0234_probe,
 	.remove = ar0234_remove,
@@ -14,30 +14,26 @@
 #else
 #include <linux/unaligned.h>
 #endif
+#include <media/v4l2-cci.h>
 #include <media/v4l2-ctrls.h>
 #include <media/v4l2-device.h>
+#include <media/v4l2-event.h>
 #include <media/v4l2-fwnode.h>
 #include "media/i2c/ar0820.h"
+#include "media/sensor-fsin.h"
+#include "media/sensor-regseq.h"
+
 #if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 10, 0)
 #include <media/mipi-csi2.h>
 #endif
 #define to_ar0820(_sd)                  container_of(_sd, struct ar0820, sd)
 
+/* Default power/autosuspend_delay_ms, keeps the mode across short gaps */
+#define AR0820_AUTOSUSPEND_DELAY_MS     5000
 
-struct ar0820_reg {
-        enum {
-                AR0820_REG_LEN_DELAY = 0,
-                AR0820_REG_LEN_08BIT = 1,
-                AR0820_REG_LEN_16BIT = 2,
-        } mode;
-        u16 address;
-        u16 val;
-};
+/* V4L2_EVENT_FRAME_SYNC events kept per subscriber */
+#define AR0820_FRAME_SYNC_EVENTS        8
 
-struct ar0820_reg_list {
-        u32 num_of_regs;
-        const struct ar0820_reg *regs;
-};
 
 struct ar0820_mode {
         /* Frame width in pixels */
@@ -52,8 +48,8 @@ struct ar0820_mode {
         /* MODE_FPS*/
         u32 fps;
 
-        /* Sensor register settings for this resolution */
-        const struct ar0820_reg_list reg_list;
+        /* Sensor register settings for this resolution, NULL if none */
+        const struct sensor_blob *regs;
 };
 
 struct ar0820 {
@@ -70,34 +66,30 @@ struct ar0820 {
 
         /* i2c client */
         struct i2c_client *client;
+        struct regmap *regmap;
+        struct sensor_regseq regseq;
 
         struct ar0820_platform_data *platform_data;
         struct gpio_desc *reset_gpio;
 	struct gpio_desc *fsin_gpio;
+        struct sensor_fsin fsin;
+
+        /* Frame start interrupt from the "irq" gpio, 0 if none */
+        int irq;
+        u32 frame_sequence;
 
         /* Streaming on/off */
         bool streaming;
 };
 
-static const struct ar0820_reg ar0820_3840_2160_30fps_reg[] = {
-	/* TODO: Waiting for Sensing register list */
-	{0,0,0},
-	{0,0,0},
-	{0,0,0},
-};
-
-static const struct ar0820_reg_list ar0820_3840_2160_30fps_reg_list = {
-	.num_of_regs = ARRAY_SIZE(ar0820_3840_2160_30fps_reg),
-	.regs = ar0820_3840_2160_30fps_reg,
-};
-
 static const struct ar0820_mode supported_modes[] = {
 	{
 		.width = 3840,
 		.height = 2160,
 		.code = MEDIA_BUS_FMT_UYVY8_1X16,
 		.fps = 30,
-		.reg_list = ar0820_3840_2160_30fps_reg_list,
+		/* TODO: Waiting for Sensing register list */
+		.regs = NULL,
 	},
 };
 
@@ -123,9 +115,30 @@ static void ar0820_update_pad_format(const struct ar0820_mode *mode,
 static int ar0820_start_streaming(struct ar0820 *ar0820)
 {
         struct i2c_client *client = ar0820->client;
+        enum sensor_regseq_phase phase;
+        ktime_t start;
+        int ret;
 
         dev_dbg(&client->dev, "%s: Enter", __func__);
 
+        /* Apply mode registers only if mode changed and a list exists */
+        if (ar0820->cur_mode->regs &&
+            ar0820->cur_mode != ar0820->pre_mode) {
+                phase = sensor_regseq_set_phase(&ar0820->regseq,
+                                                SENSOR_REGSEQ_PHASE_MODE);
+                start = ktime_get();
+                ret = sensor_regseq_write_blob(&ar0820->regseq,
+                                               ar0820->cur_mode->regs, NULL);
+                sensor_regseq_trace_step(&ar0820->regseq, "table-load", start,
+                                         ret);
+                sensor_regseq_set_phase(&ar0820->regseq, phase);
+                if (ret) {
+                        dev_err(&client->dev, "failed to set mode: %d\n", ret);
+                        return ret;
+                }
+                ar0820->pre_mode = ar0820->cur_mode;
+        }
+
         return 0;
 }
 
@@ -142,6 +155,7 @@ static int ar0820_set_stream(struct v4l2_subdev *subdev, int enable)
 {
         struct ar0820 *ar0820 = to_ar0820(subdev);
         struct i2c_client *client = ar0820->client;
+        ktime_t start = ktime_get();
 	int ret = 0;
 
         dev_dbg(&client->dev, "%s: Enter", __func__);
@@ -159,14 +173,29 @@ static int ar0820_set_stream(struct v4l2_subdev *subdev, int enable)
 		}
 
 		ret = ar0820_start_streaming(ar0820);
+		sensor_regseq_trace_step(&ar0820->regseq, "stream-on", start,
+					 ret);
+		if (!ret) {
+			if (ar0820->irq) {
+				ar0820->frame_sequence = 0;
+				enable_irq(ar0820->irq);
+			}
+			ret = sensor_fsin_start(&ar0820->fsin);
+			if (ret && ar0820->irq)
+				disable_irq(ar0820->irq);
+		}
 		if (ret) {
 			enable = 0;
-			ret = ar0820_stop_streaming(ar0820);
+			ar0820_stop_streaming(ar0820);
 			pm_runtime_put(&client->dev);
 		}
 	} else {
+		sensor_fsin_stop(&ar0820->fsin);
+		if (ar0820->irq)
+			disable_irq(ar0820->irq);
 		ret = ar0820_stop_streaming(ar0820);
-		pm_runtime_put(&client->dev);
+		pm_runtime_mark_last_busy(&client->dev);
+		pm_runtime_put_autosuspend(&client->dev);
 	}
 	
         ar0820->streaming = enable;
@@ -210,6 +239,16 @@ static int __maybe_unused ar0820_resume(struct device *dev)
 	return 0;
 }
 
+/* The power domain may cut the sensor, so reload the mode on next stream */
+static int __maybe_unused ar0820_runtime_suspend(struct device *dev)
+{
+        struct ar0820 *ar0820 = to_ar0820(dev_get_drvdata(dev));
+
+        ar0820->pre_mode = NULL;
+
+        return 0;
+}
+
 #if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 10, 0)
 static unsigned int ar0820_mbus_code_to_mipi(u32 code)
 {
@@ -376,6 +415,20 @@ static int ar0820_open(struct v4l2_subdev *subdev, struct v4l2_subdev_fh *fh)
 	return 0;
 }
 
+static int ar0820_subscribe_event(struct v4l2_subdev *sd, struct v4l2_fh *fh,
+                                  struct v4l2_event_subscription *sub)
+{
+        if (sub->type != V4L2_EVENT_FRAME_SYNC || !to_ar0820(sd)->irq)
+                return -EINVAL;
+
+        return v4l2_event_subscribe(fh, sub, AR0820_FRAME_SYNC_EVENTS, NULL);
+}
+
+static const struct v4l2_subdev_core_ops ar0820_core_ops = {
+        .subscribe_event = ar0820_subscribe_event,
+        .unsubscribe_event = v4l2_event_subdev_unsubscribe,
+};
+
 static const struct v4l2_subdev_video_ops ar0820_video_ops = {
         .s_stream = ar0820_set_stream,
 };
@@ -389,6 +442,7 @@ static const struct v4l2_subdev_pad_ops ar0820_pad_ops = {
 };
 
 static const struct v4l2_subdev_ops ar0820_subdev_ops = {
+        .core = &ar0820_core_ops,
         .video = &ar0820_video_ops,
         .pad = &ar0820_pad_ops,
 };
@@ -401,6 +455,68 @@ static const struct v4l2_subdev_internal_ops ar0820_internal_ops = {
         .open = ar0820_open,
 };
 
+/*
+ * Frame start from the sensor, timestamped with CLOCK_MONOTONIC by the
+ * event core when queued.
+ */
+static irqreturn_t ar0820_irq(int irq, void *data)
+{
+        struct ar0820 *ar0820 = data;
+        struct v4l2_event event = {
+                .type = V4L2_EVENT_FRAME_SYNC,
+                .u.frame_sync.frame_sequence = ar0820->frame_sequence++,
+        };
+
+        v4l2_event_queue(ar0820->sd.devnode, &event);
+
+        return IRQ_HANDLED;
+}
+
+/*
+ * The frame start interrupt comes from the "irq" GPIO of the firmware node
+ * or of a board GPIO lookup table, with the trigger in irq_pin_flags. The
+ * driver does not program any sensor pin for it, the board has to wire a
+ * sensor (or serializer) output that already carries frame start. The
+ * interrupt stays disabled until the sensor streams.
+ */
+static int ar0820_irq_init(struct ar0820 *ar0820)
+{
+        struct ar0820_platform_data *pdata = ar0820->platform_data;
+        struct device *dev = &ar0820->client->dev;
+        struct gpio_desc *gpio;
+        int irq, ret;
+
+        if (!pdata || !pdata->irq_pin_flags)
+                return 0;
+
+        gpio = devm_gpiod_get_optional(dev, "irq", GPIOD_IN);
+        if (IS_ERR(gpio))
+                return dev_err_probe(dev, PTR_ERR(gpio),
+                                     "failed to get irq gpio\n");
+        if (!gpio)
+                return 0;
+        if (pdata->irq_pin_name[0])
+                gpiod_set_consumer_name(gpio, pdata->irq_pin_name);
+
+        irq = gpiod_to_irq(gpio);
+        if (irq < 0) {
+                dev_err(dev, "no interrupt for irq gpio: %d\n", irq);
+                return irq;
+        }
+
+        ret = devm_request_any_context_irq(dev, irq, ar0820_irq,
+                                           pdata->irq_pin_flags,
+                                           dev_name(dev), ar0820);
+        if (ret < 0) {
+                dev_err(dev, "failed to request irq %d: %d\n", irq, ret);
+                return ret;
+        }
+        disable_irq(irq);
+        ar0820->irq = irq;
+
+        return 0;
+}
+
 #if LINUX_VERSION_CODE < KERNEL_VERSION(6, 1, 0)
 static int ar0820_remove(struct i2c_client *client)
 #else
@@ -409,6 +525,9 @@ static void ar0820_remove(struct i2c_client *client)
 {
         dev_dbg(&client->dev, "%s: Enter", __func__);
 
+        pm_runtime_dont_use_autosuspend(&client->dev);
+        pm_runtime_disable(&client->dev);
+
 #if LINUX_VERSION_CODE < KERNEL_VERSION(6, 1, 0)
 	return 0;
 #endif
@@ -442,6 +561,15 @@ static int ar0820_probe(struct i2c_client *client)
                 dev_dbg(&client->dev, "Found reset GPIO");
         }
 
+        ar0820->regmap = devm_cci_regmap_init_i2c(client, 16);
+        if (IS_ERR(ar0820->regmap))
+                return dev_err_probe(&client->dev, PTR_ERR(ar0820->regmap),
+                                     "failed to init CCI\n");
+        sensor_regseq_init(&ar0820->regseq, &client->dev, ar0820->regmap);
+        ret = sensor_regseq_debugfs_init(&ar0820->regseq);
+        if (ret)
+                return ret;
+
         ar0820->fsin_gpio = devm_gpiod_get_optional(&client->dev, "fsin",
                                 		    GPIOD_OUT_LOW);
 
@@ -452,15 +580,19 @@ static int ar0820_probe(struct i2c_client *client)
         else {
                 dev_dbg(&client->dev, "Found FSIN GPIO");
         }
+
+        ret = sensor_fsin_init(&ar0820->fsin, &client->dev, ar0820->fsin_gpio);
+        if (ret)
+                return ret;
+
+        ret = ar0820_irq_init(ar0820);
+        if (ret)
+                return ret;
 	
         /* initialize subdevice */
         sd = &ar0820->sd;
         v4l2_i2c_subdev_init(sd, client, &ar0820_subdev_ops);
-#if LINUX_VERSION_CODE < KERNEL_VERSION(6, 10, 0)
         sd->flags |= V4L2_SUBDEV_FL_HAS_DEVNODE | V4L2_SUBDEV_FL_HAS_EVENTS;
-#else
-        sd->flags |= V4L2_SUBDEV_FL_HAS_DEVNODE;
-#endif
         sd->internal_ops = &ar0820_internal_ops;
         sd->entity.ops = &ar0820_subdev_entity_ops;
         sd->entity.function = MEDIA_ENT_F_CAM_SENSOR;
@@ -486,8 +618,8 @@ static int ar0820_probe(struct i2c_client *client)
 
         mutex_init(&ar0820->mutex);
 
-        ar0820->pre_mode = &supported_modes[0];
-        ar0820->cur_mode = ar0820->pre_mode;
+        ar0820->pre_mode = NULL;
+        ar0820->cur_mode = &supported_modes[0];
 #if LINUX_VERSION_CODE < KERNEL_VERSION(5, 13, 0)
         ret = v4l2_async_register_subdev_sensor_common(&ar0820->sd);
 #else
@@ -501,12 +633,18 @@ static int ar0820_probe(struct i2c_client *client)
 
         /*
          * Device is already turned on by i2c-core with ACPI domain PM.
-         * Enable runtime PM and turn off the device.
+         * Enable runtime PM and turn off the device once the autosuspend
+         * delay expired. Runtime suspend forgets the programmed mode.
          */
         pm_runtime_set_active(&client->dev);
+        pm_runtime_set_autosuspend_delay(&client->dev,
+                                         AR0820_AUTOSUSPEND_DELAY_MS);
+        pm_runtime_use_autosuspend(&client->dev);
         pm_runtime_enable(&client->dev);
         pm_runtime_idle(&client->dev);
 
+        sensor_regseq_set_phase(&ar0820->regseq, SENSOR_REGSEQ_PHASE_OTHER);
+
         dev_dbg(&client->dev, "%s: Leave ", __func__);
 	
         return 0;
@@ -520,6 +658,7 @@ probe_error_media_entity_cleanup:
 
 static const struct dev_pm_ops ar0820_pm_ops = {
         SET_SYSTEM_SLEEP_PM_OPS(ar0820_suspend, ar0820_resume)
+        SET_RUNTIME_PM_OPS(ar0820_runtime_suspend, ar0820_resume, NULL)
 };
 
 static const struct i2c_device_id ar0820_id_table[] = {
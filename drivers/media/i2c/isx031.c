@@ -2,77 +2,104 @@
 // Copyright (c) 2022-2025 Intel Corporation.
 
 #include <linux/acpi.h>
+#include <linux/completion.h>
 #include <linux/delay.h>
 #include <linux/gpio.h>
 #include <linux/i2c.h>
 #include <linux/interrupt.h>
 #include <linux/module.h>
 #include <linux/pm_runtime.h>
+#include <linux/regmap.h>
 #include <linux/version.h>
-#if LINUX_VERSION_CODE < KERNEL_VERSION(6, 12, 0)
-#include <asm/unaligned.h>
-#else
-#include <linux/unaligned.h>
-#endif
+#include <linux/workqueue.h>
 #if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 10, 0)
 #include <media/mipi-csi2.h>
 #endif
+#include <media/v4l2-cci.h>
 #include <media/v4l2-ctrls.h>
 #include <media/v4l2-device.h>
+#include <media/v4l2-event.h>
 #include <media/v4l2-fwnode.h>
 
 #include "media/i2c/isx031.h"
+#include "media/sensor-fsin.h"
+#include "media/sensor-regseq.h"
+
+#include "isx031-regs.h"
 
 #define to_isx031(_sd)	container_of(_sd, struct isx031, sd)
 
-#define ISX031_OTP_TYPE_NAME_L		0x7E8A
-#define ISX031_OTP_TYPE_NAME_H		0x7E8B
+#define ISX031_OTP_TYPE_NAME_L		CCI_REG8(0x7E8A)
+#define ISX031_OTP_TYPE_NAME_H		CCI_REG8(0x7E8B)
 #define ISX031_OTP_TYPE_NAME_H_FIELD	0x0F
 #define ISX031_OTP_MODULE_ID_L		0x031
 
-#define ISX031_REG_MODE_SET_F		0x8A01
+#define ISX031_REG_MODE_SET_F		CCI_REG8(0x8A01)
 #define ISX031_MODE_STANDBY		0x00
 #define ISX031_MODE_STREAMING		0x80
 
-#define ISX031_REG_SENSOR_STATE		0x6005
+#define ISX031_REG_SENSOR_STATE		CCI_REG8(0x6005)
 #define ISX031_STATE_STREAMING		0x05
 #define ISX031_STATE_STARTUP		0x02
 
-#define ISX031_REG_MODE_SET_F_LOCK	0xBEF0
+#define ISX031_REG_MODE_SET_F_LOCK	CCI_REG8(0xBEF0)
 #define ISX031_MODE_UNLOCK		0x53
 
-#define ISX031_REG_MODE_SELECT		0x8A00
+#define ISX031_REG_MODE_SELECT		CCI_REG8(0x8A00)
 #define ISX031_MODE_4LANES_60FPS	0x01
 #define ISX031_MODE_4LANES_30FPS	0x17
 #define ISX031_MODE_2LANES_30FPS	0x18
 
-#define ISX031_READ_REG_RETRY_TIMEOUT	50
-#define ISX031_WRITE_REG_RETRY_TIMEOUT	100
 #define ISX031_PM_RETRY_TIMEOUT		10
-#define ISX031_REG_SLEEP_10000US	10000	/* 10ms */
-#define ISX031_REG_SLEEP_20MS		20	/* 20ms */
 #define ISX031_REG_SLEEP_200MS		200	/* 200ms */
 
-/* To serialize asynchronous callbacks */
-static DEFINE_MUTEX(isx031_mutex);
-
-struct isx031_reg {
-	enum {
-		ISX031_REG_LEN_DELAY = 0,
-		ISX031_REG_LEN_08BIT = 1,
-		ISX031_REG_LEN_16BIT = 2,
-	} mode;
-	u16 address;
-	u16 val;
+/* Default power/autosuspend_delay_ms, keeps the mode across short gaps */
+#define ISX031_AUTOSUSPEND_DELAY_MS	5000
+
+/* V4L2_EVENT_FRAME_SYNC events kept per subscriber */
+#define ISX031_FRAME_SYNC_EVENTS	8
+
+/* Upper bound for a sensor state transition to complete */
+#define ISX031_STATE_TIMEOUT_US		1000000
+
+static bool fast_resume = true;
+module_param(fast_resume, bool, 0644);
+MODULE_PARM_DESC(fast_resume,
+		 "Poll for the sensor after reset and skip identify on resume");
+
+static bool adopt;
+module_param(adopt, bool, 0644);
+MODULE_PARM_DESC(adopt,
+		 "Keep a sensor found at probe already programmed with the default mode");
+
+static unsigned int state_poll_us = 200;
+module_param(state_poll_us, uint, 0644);
+MODULE_PARM_DESC(state_poll_us,
+		 "Sensor state poll interval during mode transitions (us)");
+
+/* Sensor state polling, ~500ms budget */
+static const struct sensor_regseq_retry_policy isx031_state_retry = {
+	.min_us		= 100,
+	.max_us		= 10000,
+	.timeout_us	= 500000,
+};
+
+/* OTP reads during identify, ~500ms budget */
+static const struct sensor_regseq_retry_policy isx031_otp_retry = {
+	.min_us		= 500,
+	.max_us		= 10000,
+	.timeout_us	= 500000,
 };
 
-struct isx031_reg_list {
-	u32 num_of_regs;
-	const struct isx031_reg *regs;
+/* Register list writes, ~2s budget */
+static const struct sensor_regseq_retry_policy isx031_write_retry = {
+	.min_us		= 200,
+	.max_us		= 20000,
+	.timeout_us	= 2000000,
 };
 
 struct isx031_link_freq_config {
-	const struct isx031_reg_list reg_list;
+	const struct sensor_blob *regs;
 };
 
 struct isx031_drive_mode {
@@ -98,141 +125,58 @@ struct isx031_mode {
 	u32 fps;	/* MODE_FPS */
 
 	/* Sensor register settings for a specific resolution */
-	const struct isx031_reg_list reg_list;
+	const struct sensor_blob *regs;
 };
 
 struct isx031 {
 	struct v4l2_subdev sd;
 	struct v4l2_ctrl_handler ctrls;
+	struct v4l2_ctrl *link_freq;
+	struct v4l2_ctrl *pixel_rate;
 
 	struct isx031_platform_data *platform_data;
 	struct i2c_client *client;
+	struct regmap *regmap;
+	struct sensor_regseq regseq;
 
 	struct gpio_desc *reset_gpio;
 	struct gpio_desc *fsin_gpio;
+	struct sensor_fsin fsin;
 	struct media_pad pad;
 
+	/* Frame start interrupt from the "irq" gpio, 0 if none */
+	int irq;
+	u32 frame_sequence;
+
 	const struct isx031_mode *cur_mode;	/* Current mode */
 	const struct isx031_mode *pre_mode;	/* Previous mode */
 
+	/* Measured duration of the last transition to each state */
+	u32 startup_transit_us;
+	u32 streaming_transit_us;
+
+	/* Sensor identify and init, deferred from probe */
+	struct work_struct init_work;
+	struct completion init_done;
+	int init_ret;
+
+	bool identified;	/* OTP module ID checked since probe */
+	bool powered_off;	/* Held in reset since system suspend */
 	u8 lanes;
 	bool streaming;	/* Streaming on/off */
 };
 
+/*
+ * Only the 30 fps drive modes are offered: the link frequency of the 4-lane
+ * 60 fps drive mode is not confirmed, and a wrong LINK_FREQ keeps the
+ * receiver's D-PHY from locking.
+ */
 static const s64 isx031_link_frequencies[] = {
 	300000000ULL,
 };
 
-static const struct isx031_reg isx031_init_reg[] = {
-	{ISX031_REG_LEN_08BIT, 0xFFFF, 0x00}, /* Select mode */
-	{ISX031_REG_LEN_08BIT, 0x0171, 0x00}, /* Close F_EBD */
-	{ISX031_REG_LEN_08BIT, 0x0172, 0x00}, /* Close R_EBD */
-	{}
-};
-
-static const struct isx031_reg isx031_framesync_reg[] = {
-	{ISX031_REG_LEN_08BIT, 0xBF14, 0x01}, /* SG_MODE_APL */
-	{ISX031_REG_LEN_08BIT, 0x8AFF, 0x0c}, /* Hi-Z (input setting or output disabled) */
-	{ISX031_REG_LEN_08BIT, 0x0153, 0x00},
-	{ISX031_REG_LEN_08BIT, 0x8AF0, 0x01}, /* External pulse-based sync */
-	{ISX031_REG_LEN_08BIT, 0x0144, 0x00},
-	{ISX031_REG_LEN_08BIT, 0x8AF1, 0x00},
-	{}
-};
-
-static const struct isx031_reg isx031_1920_1536_30fps_reg[] = {
-	{ISX031_REG_LEN_08BIT, 0x8AA8, 0x01}, /* Crop enable */
-	{ISX031_REG_LEN_08BIT, 0x8AAA, 0x80}, /* H size = 1920 */
-	{ISX031_REG_LEN_08BIT, 0x8AAB, 0x07},
-	{ISX031_REG_LEN_08BIT, 0x8AAC, 0x00}, /* H croped 0 */
-	{ISX031_REG_LEN_08BIT, 0x8AAD, 0x00},
-	{ISX031_REG_LEN_08BIT, 0x8AAE, 0x00}, /* V size 1536 */
-	{ISX031_REG_LEN_08BIT, 0x8AAF, 0x06},
-	{ISX031_REG_LEN_08BIT, 0x8AB0, 0x00}, /* V cropped 0 */
-	{ISX031_REG_LEN_08BIT, 0x8AB1, 0x00},
-	{ISX031_REG_LEN_08BIT, 0x8ADA, 0x03}, /* DCROP_DATA_SEL */
-	{ISX031_REG_LEN_08BIT, 0xBF04, 0x01},
-	{ISX031_REG_LEN_08BIT, 0xBF06, 0x80},
-	{ISX031_REG_LEN_08BIT, 0xBF07, 0x07},
-	{ISX031_REG_LEN_08BIT, 0xBF08, 0x00},
-	{ISX031_REG_LEN_08BIT, 0xBF09, 0x00},
-	{ISX031_REG_LEN_08BIT, 0xBF0A, 0x00},
-	{ISX031_REG_LEN_08BIT, 0xBF0B, 0x06},
-	{ISX031_REG_LEN_08BIT, 0xBF0C, 0x00},
-	{ISX031_REG_LEN_08BIT, 0xBF0D, 0x00},
-	{}
-};
-
-static const struct isx031_reg isx031_1920_1080_30fps_reg[] = {
-	{ISX031_REG_LEN_08BIT, 0x8AA8, 0x01}, /* Crop enable */
-	{ISX031_REG_LEN_08BIT, 0x8AAA, 0x80}, /* H size = 1920 */
-	{ISX031_REG_LEN_08BIT, 0x8AAB, 0x07},
-	{ISX031_REG_LEN_08BIT, 0x8AAC, 0x00}, /* H croped 0 */
-	{ISX031_REG_LEN_08BIT, 0x8AAD, 0x00},
-	{ISX031_REG_LEN_08BIT, 0x8AAE, 0x38}, /* V size 1080 */
-	{ISX031_REG_LEN_08BIT, 0x8AAF, 0x04},
-	{ISX031_REG_LEN_08BIT, 0x8AB0, 0xE4}, /* V cropped 228*2 */
-	{ISX031_REG_LEN_08BIT, 0x8AB1, 0x00},
-	{ISX031_REG_LEN_08BIT, 0x8ADA, 0x03}, /* DCROP_DATA_SEL */
-	{ISX031_REG_LEN_08BIT, 0xBF04, 0x01},
-	{ISX031_REG_LEN_08BIT, 0xBF06, 0x80},
-	{ISX031_REG_LEN_08BIT, 0xBF07, 0x07},
-	{ISX031_REG_LEN_08BIT, 0xBF08, 0x00},
-	{ISX031_REG_LEN_08BIT, 0xBF09, 0x00},
-	{ISX031_REG_LEN_08BIT, 0xBF0A, 0x38},
-	{ISX031_REG_LEN_08BIT, 0xBF0B, 0x04},
-	{ISX031_REG_LEN_08BIT, 0xBF0C, 0xE4},
-	{ISX031_REG_LEN_08BIT, 0xBF0D, 0x00},
-	{}
-};
-
-static const struct isx031_reg isx031_1280_720_30fps_reg[] = {
-	{ISX031_REG_LEN_08BIT, 0x8AA8, 0x01}, /* Crop enable */
-	{ISX031_REG_LEN_08BIT, 0x8AAA, 0x00}, /* H size = 1280 */
-	{ISX031_REG_LEN_08BIT, 0x8AAB, 0x05},
-	{ISX031_REG_LEN_08BIT, 0x8AAC, 0x40}, /* H croped 320*2 */
-	{ISX031_REG_LEN_08BIT, 0x8AAD, 0x01},
-	{ISX031_REG_LEN_08BIT, 0x8AAE, 0xD0}, /* V size 720 */
-	{ISX031_REG_LEN_08BIT, 0x8AAF, 0x02},
-	{ISX031_REG_LEN_08BIT, 0x8AB0, 0x98}, /* V cropped 408*2 */
-	{ISX031_REG_LEN_08BIT, 0x8AB1, 0x01},
-	{ISX031_REG_LEN_08BIT, 0x8ADA, 0x03}, /* DCROP_DATA_SEL */
-	{ISX031_REG_LEN_08BIT, 0xBF04, 0x01},
-	{ISX031_REG_LEN_08BIT, 0xBF06, 0x00},
-	{ISX031_REG_LEN_08BIT, 0xBF07, 0x05},
-	{ISX031_REG_LEN_08BIT, 0xBF08, 0x40},
-	{ISX031_REG_LEN_08BIT, 0xBF09, 0x01},
-	{ISX031_REG_LEN_08BIT, 0xBF0A, 0xD0},
-	{ISX031_REG_LEN_08BIT, 0xBF0B, 0x02},
-	{ISX031_REG_LEN_08BIT, 0xBF0C, 0x98},
-	{ISX031_REG_LEN_08BIT, 0xBF0D, 0x01},
-	{}
-};
-
-static const struct isx031_reg_list isx031_init_reg_list = {
-	.num_of_regs = ARRAY_SIZE(isx031_init_reg),
-	.regs = isx031_init_reg,
-};
-
-static const struct isx031_reg_list isx031_framesync_reg_list = {
-	.num_of_regs = ARRAY_SIZE(isx031_framesync_reg),
-	.regs = isx031_framesync_reg,
-};
-
-static const struct isx031_reg_list isx031_1920_1536_30fps_reg_list = {
-	.num_of_regs = ARRAY_SIZE(isx031_1920_1536_30fps_reg),
-	.regs = isx031_1920_1536_30fps_reg,
-};
-
-static const struct isx031_reg_list isx031_1920_1080_30fps_reg_list = {
-	.num_of_regs = ARRAY_SIZE(isx031_1920_1080_30fps_reg),
-	.regs = isx031_1920_1080_30fps_reg,
-};
-
-static const struct isx031_reg_list isx031_1280_720_30fps_reg_list = {
-	.num_of_regs = ARRAY_SIZE(isx031_1280_720_30fps_reg),
-	.regs = isx031_1280_720_30fps_reg,
-};
+/* MEDIA_BUS_FMT_UYVY8_1X16 */
+#define ISX031_BPP			16
 
 static const struct isx031_mode supported_modes[] = {
 	{
@@ -243,7 +187,7 @@ static const struct isx031_mode supported_modes[] = {
 		.datatype	= MIPI_CSI2_DT_YUV422_8B,
 #endif
 		.fps		= 30,
-		.reg_list	= isx031_1920_1536_30fps_reg_list,
+		.regs		= &isx031_1920_1536_regs,
 	},
 	{
 		.width		= 1920,
@@ -253,7 +197,7 @@ static const struct isx031_mode supported_modes[] = {
 		.datatype	= MIPI_CSI2_DT_YUV422_8B,
 #endif
 		.fps		= 30,
-		.reg_list	= isx031_1920_1080_30fps_reg_list,
+		.regs		= &isx031_1920_1080_regs,
 	},
 	{
 		.width		= 1280,
@@ -263,143 +207,84 @@ static const struct isx031_mode supported_modes[] = {
 		.datatype	= MIPI_CSI2_DT_YUV422_8B,
 #endif
 		.fps		= 30,
-		.reg_list	= isx031_1280_720_30fps_reg_list,
+		.regs		= &isx031_1280_720_regs,
 	},
 };
 
-static int isx031_read_reg(struct i2c_client *client, u16 reg, u16 len, u32 *val)
-{
-	struct i2c_msg msgs[2];
-	u8 addr_buf[2];
-	u8 data_buf[4] = { 0 };
-	int ret;
-
-	if (len > 4)
-		return -EINVAL;
-
-	put_unaligned_be16(reg, addr_buf);
-
-	msgs[0].addr = client->addr;
-	msgs[0].flags = 0;
-	msgs[0].len = sizeof(addr_buf);
-	msgs[0].buf = addr_buf;
-
-	msgs[1].addr = client->addr;
-	msgs[1].flags = I2C_M_RD;
-	msgs[1].len = len;
-	msgs[1].buf = &data_buf[4 - len];
-
-	ret = i2c_transfer(client->adapter, msgs, ARRAY_SIZE(msgs));
-	if (ret != ARRAY_SIZE(msgs))
-		return -EIO;
-
-	*val = get_unaligned_be32(data_buf);
-
-	return 0;
-}
+/*
+ * Registers kept in the regcache: drive mode, embedded data, crop and
+ * framesync setup. Everything else (state, mode set command, unlock key,
+ * OTP, page select) always goes to the bus.
+ */
+static const struct regmap_range isx031_cached_ranges[] = {
+	regmap_reg_range(0x0144, 0x0144),
+	regmap_reg_range(0x0153, 0x0153),
+	regmap_reg_range(0x0171, 0x0172),
+	regmap_reg_range(0x8A00, 0x8A00),
+	regmap_reg_range(0x8AA8, 0x8AB1),
+	regmap_reg_range(0x8ADA, 0x8ADA),
+	regmap_reg_range(0x8AF0, 0x8AF1),
+	regmap_reg_range(0x8AFF, 0x8AFF),
+	regmap_reg_range(0xBF04, 0xBF0D),
+	regmap_reg_range(0xBF14, 0xBF14),
+};
 
-static int isx031_read_reg_state(struct i2c_client *client, u32 *val)
+static bool isx031_volatile_reg(struct device *dev, unsigned int reg)
 {
-	int ret;
-	int i;
-
-	for (i = 0; i < ISX031_READ_REG_RETRY_TIMEOUT; i++) {
-		ret = isx031_read_reg(client, ISX031_REG_SENSOR_STATE,
-				      ISX031_REG_LEN_08BIT, val);
-		if (!ret)
-			return 0;
+	return !regmap_reg_in_ranges(reg, isx031_cached_ranges,
+				     ARRAY_SIZE(isx031_cached_ranges));
+}
 
-		usleep_range(ISX031_REG_SLEEP_10000US,
-			     ISX031_REG_SLEEP_10000US + 500);
-	}
+static const struct regmap_config isx031_regmap_config = {
+	.reg_bits = 16,
+	.val_bits = 8,
+	.max_register = 0xFFFF,
+	.volatile_reg = isx031_volatile_reg,
+	.cache_type = REGCACHE_MAPLE,
+};
 
-	return ret;
+static int isx031_read_reg_state(struct isx031 *isx031, u64 *val)
+{
+	return sensor_regseq_read(&isx031->regseq, ISX031_REG_SENSOR_STATE, val,
+				  &isx031_state_retry);
 }
 
-static int isx031_read_reg_otp(struct i2c_client *client, u16 reg, u32 *val)
+static int isx031_read_reg_otp(struct isx031 *isx031, u32 reg, u64 *val)
 {
-	int ret;
-	int i;
-
-	for (i = 0; i < ISX031_READ_REG_RETRY_TIMEOUT; i++) {
-		ret = isx031_read_reg(client, reg, ISX031_REG_LEN_08BIT, val);
-		if (!ret)
-			return 0;
-
-		usleep_range(ISX031_REG_SLEEP_10000US,
-			     ISX031_REG_SLEEP_10000US + 500);
-	}
-
-	return ret;
+	return sensor_regseq_read(&isx031->regseq, reg, val, &isx031_otp_retry);
 }
 
-static int isx031_write_reg(struct i2c_client *client, u16 reg, u16 len, u32 val)
+static int isx031_write_reg(struct isx031 *isx031, u32 reg, u64 val)
 {
-	u8 buf[6];
-	int ret;
-
-	if (len > 4)
-		return -EINVAL;
-
-	put_unaligned_be16(reg, buf);
-	put_unaligned_be32(val << (8 * (4 - len)), buf + 2);
-
-	ret = i2c_master_send(client, buf, len + 2);
-	if (ret != len + 2)
-		return -EIO;
-
-	return 0;
+	return sensor_regseq_write(&isx031->regseq, reg, val, NULL);
 }
 
-static int isx031_write_reg_retry(struct i2c_client *client, u16 reg, u16 len, u32 val)
+static int isx031_write_regs(struct isx031 *isx031,
+			     const struct sensor_blob *regs, bool is_retry)
 {
-	int ret;
-	int i;
-
-	for (i = 0; i < ISX031_WRITE_REG_RETRY_TIMEOUT; i++) {
-		ret = isx031_write_reg(client, reg, len, val);
-		if (!ret)
-			return 0;
-
-		msleep(ISX031_REG_SLEEP_20MS);
-	}
-
-	return ret;
+	return sensor_regseq_write_blob(&isx031->regseq, regs,
+					is_retry ? &isx031_write_retry : NULL);
 }
 
-static int isx031_write_reg_list(struct i2c_client *client,
-				 const struct isx031_reg_list *r_list,
-				 bool is_retry)
+/*
+ * Registers to write for cur_mode: the delta from pre_mode precomputed by
+ * sensor-regseq-gen (see isx031.regs) if the sensor still holds a mode,
+ * the full list otherwise.
+ */
+static const struct sensor_blob *isx031_mode_regs(struct isx031 *isx031)
 {
-	unsigned int i;
-	int ret;
-
-	for (i = 0; i < r_list->num_of_regs; i++) {
-		const struct isx031_reg *reg = &r_list->regs[i];
+	const struct sensor_blob *delta;
 
-		if (reg->mode == ISX031_REG_LEN_DELAY) {
-			msleep(reg->val);
-			continue;
-		}
+	BUILD_BUG_ON(ARRAY_SIZE(isx031_mode_deltas) !=
+		     ARRAY_SIZE(supported_modes));
 
-		if (is_retry)
-			ret = isx031_write_reg_retry(client, reg->address,
-						     ISX031_REG_LEN_08BIT,
-						     reg->val);
-		else
-			ret = isx031_write_reg(client, reg->address,
-					       ISX031_REG_LEN_08BIT,
-					       reg->val);
+	if (!isx031->pre_mode)
+		return isx031->cur_mode->regs;
 
-		if (ret) {
-			dev_err_ratelimited(&client->dev,
-					    "write reg failed (addr=0x%04x, err=%d)\n",
-					    reg->address, ret);
-			return ret;
-		}
-	}
+	delta = isx031_mode_deltas[isx031->pre_mode - supported_modes]
+				  [isx031->cur_mode - supported_modes];
 
-	return 0;
+	return delta ?: isx031->cur_mode->regs;
 }
 
 static int isx031_find_drive_mode(int lanes, int fps)
@@ -426,7 +311,71 @@ static int isx031_set_drive_mode(struct isx031 *isx031)
 		return mode;
 	}
 
-	ret = isx031_write_reg(client, ISX031_REG_MODE_SELECT, 1, mode);
+	ret = isx031_write_reg(isx031, ISX031_REG_MODE_SELECT, mode);
+
+	return ret;
+}
+
+/* Whether the lane configuration has a drive mode for @mode */
+static bool isx031_mode_supported(struct isx031 *isx031,
+				  const struct isx031_mode *mode)
+{
+	return isx031_find_drive_mode(isx031->lanes, mode->fps) >= 0;
+}
+
+/*
+ * Find the supported mode with the given format and size whose frame rate
+ * is closest to @fps, NULL if there is none.
+ */
+static const struct isx031_mode *
+isx031_find_mode(struct isx031 *isx031, u32 code, u32 width, u32 height,
+		 u32 fps)
+{
+	const struct isx031_mode *mode, *best = NULL;
+	unsigned int i;
+
+	for (i = 0; i < ARRAY_SIZE(supported_modes); i++) {
+		mode = &supported_modes[i];
+		if (mode->code != code || mode->width != width ||
+		    mode->height != height || !isx031_mode_supported(isx031, mode))
+			continue;
+
+		if (!best || abs((int)mode->fps - (int)fps) <
+			     abs((int)best->fps - (int)fps))
+			best = mode;
+	}
+
+	return best;
+}
+
+static s64 isx031_pixel_rate(struct isx031 *isx031)
+{
+	/* CSI-2 is DDR, two bits per lane and link clock cycle */
+	return div_s64(isx031_link_frequencies[0] * 2 * isx031->lanes,
+		       ISX031_BPP);
+}
+
+/*
+ * Poll the sensor state until it reports @state. NAKs and other states are
+ * polled through quietly, a timeout is reported once with the state the
+ * sensor got stuck in.
+ */
+static int isx031_poll_state(struct isx031 *isx031, u64 state)
+{
+	struct i2c_client *client = isx031->client;
+	u64 val = 0;
+	int ret;
+
+	ret = sensor_regseq_poll(&isx031->regseq, ISX031_REG_SENSOR_STATE,
+				 state, state_poll_us, ISX031_STATE_TIMEOUT_US);
+	if (ret == -ETIMEDOUT &&
+	    !sensor_regseq_read(&isx031->regseq, ISX031_REG_SENSOR_STATE, &val,
+				NULL))
+		dev_err(&client->dev, "Sensor stuck in state 0x%llx, expected 0x%llx\n",
+			val, state);
+	else if (ret)
+		dev_err(&client->dev, "Sensor did not reach state 0x%llx: %d\n",
+			state, ret);
 
 	return ret;
 }
@@ -436,7 +385,9 @@ static int isx031_mode_transit(struct isx031 *isx031, int state)
 	struct i2c_client *client = isx031->client;
 	int ret;
 	int cur_mode, mode = ISX031_MODE_STANDBY;
-	u32 val = 0;
+	u64 val = 0;
+	ktime_t start;
+	u32 transit_us;
 
 	if (state == ISX031_STATE_STARTUP)
 		mode = ISX031_MODE_STANDBY;
@@ -445,7 +396,7 @@ static int isx031_mode_transit(struct isx031 *isx031, int state)
 	else
 		return -EINVAL;
 
-	ret = isx031_read_reg_state(client, &val);
+	ret = isx031_read_reg_state(isx031, &val);
 	if (ret) {
 		dev_err(&client->dev, "Failed to read sensor state\n");
 		return ret;
@@ -458,37 +409,49 @@ static int isx031_mode_transit(struct isx031 *isx031, int state)
 		return ret;
 	}
 
-	ret = isx031_write_reg(client, ISX031_REG_MODE_SET_F_LOCK, 1,
+	ret = isx031_write_reg(isx031, ISX031_REG_MODE_SET_F_LOCK,
 			       ISX031_MODE_UNLOCK);
 	if (ret) {
 		dev_err(&client->dev, "Failed to unlock mode\n");
 		return ret;
 	}
 
-	ret = isx031_write_reg(client, ISX031_REG_MODE_SET_F, 1, mode);
+	start = ktime_get();
+	ret = isx031_write_reg(isx031, ISX031_REG_MODE_SET_F, mode);
 	if (ret) {
 		dev_err(&client->dev, "Failed to transit mode from 0x%x to 0x%x\n",
 			cur_mode, mode);
 		return ret;
 	}
 
-	ret = isx031_read_reg_state(client, &val);
-	if (ret) {
-		dev_err(&client->dev, "Failed to read sensor state\n");
+	ret = isx031_poll_state(isx031, state);
+	sensor_regseq_trace_step(&isx031->regseq,
+				 state == ISX031_STATE_STREAMING ?
+				 "state-poll-streaming" : "state-poll-startup",
+				 start, ret);
+	if (ret)
 		return ret;
-	}
+
+	transit_us = ktime_us_delta(ktime_get(), start);
+	if (state == ISX031_STATE_STREAMING)
+		isx031->streaming_transit_us = transit_us;
+	else
+		isx031->startup_transit_us = transit_us;
+
+	dev_dbg(&client->dev, "State 0x%x reached in %u us\n", state,
+		transit_us);
 
 	return 0;
 }
 
-static int isx031_initialize_module(struct isx031 *isx031)
+static int __isx031_initialize_module(struct isx031 *isx031)
 {
 	struct i2c_client *client = isx031->client;
 	int ret;
-	u32 val = 0;
+	u64 val = 0;
 
 	/* Read sensor current state */
-	ret = isx031_read_reg_state(client, &val);
+	ret = isx031_read_reg_state(isx031, &val);
 	if (ret) {
 		dev_err(&client->dev, "Failed to read sensor state\n");
 		return ret;
@@ -501,13 +464,13 @@ static int isx031_initialize_module(struct isx031 *isx031)
 			return ret;
 	}
 
-	ret = isx031_write_reg_list(client, &isx031_init_reg_list, true);
+	ret = isx031_write_regs(isx031, &isx031_init_regs, true);
 	if (ret)
 		return ret;
 
 	if (isx031->platform_data &&
 	    !isx031->platform_data->irq_pin_flags) {
-		ret = isx031_write_reg_list(client, &isx031_framesync_reg_list, false);
+		ret = isx031_write_regs(isx031, &isx031_framesync_regs, false);
 		if (ret) {
 			dev_err(&client->dev, "Failed to set framesync\n");
 			return ret;
@@ -517,20 +480,34 @@ static int isx031_initialize_module(struct isx031 *isx031)
 	return 0;
 }
 
-static int isx031_identify_module(struct i2c_client *client)
+static int isx031_initialize_module(struct isx031 *isx031)
+{
+	enum sensor_regseq_phase phase;
+	int ret;
+
+	phase = sensor_regseq_set_phase(&isx031->regseq,
+					SENSOR_REGSEQ_PHASE_INIT);
+	ret = __isx031_initialize_module(isx031);
+	sensor_regseq_set_phase(&isx031->regseq, phase);
+
+	return ret;
+}
+
+static int isx031_identify_module(struct isx031 *isx031)
 {
-	u32 name_l = 0;
-	u32 name_h = 0;
+	struct i2c_client *client = isx031->client;
+	u64 name_l = 0;
+	u64 name_h = 0;
 	u16 module_id;
 	int ret;
 
-	ret = isx031_read_reg_otp(client, ISX031_OTP_TYPE_NAME_L, &name_l);
+	ret = isx031_read_reg_otp(isx031, ISX031_OTP_TYPE_NAME_L, &name_l);
 	if (ret) {
 		dev_err(&client->dev, "Failed to read OTP NAME_L register\n");
 		return ret;
 	}
 
-	ret = isx031_read_reg_otp(client, ISX031_OTP_TYPE_NAME_H, &name_h);
+	ret = isx031_read_reg_otp(isx031, ISX031_OTP_TYPE_NAME_H, &name_h);
 	if (ret) {
 		dev_err(&client->dev, "Failed to read OTP NAME_H register\n");
 		return ret;
@@ -597,33 +574,56 @@ out_err:
 static int isx031_start_streaming(struct isx031 *isx031)
 {
 	struct i2c_client *client = isx031->client;
-	const struct isx031_reg_list *reg_list;
+	enum sensor_regseq_phase phase;
+	const struct sensor_blob *regs;
+	ktime_t begin, start;
 	int ret;
 
-	/* Apply mode registers only if mode changed */
+	begin = ktime_get();
+
+	/*
+	 * Apply mode registers only if mode changed, and only those that
+	 * differ from the previous mode.
+	 */
 	if (isx031->cur_mode != isx031->pre_mode) {
-		reg_list = &isx031->cur_mode->reg_list;
-		ret = isx031_write_reg_list(client, reg_list, true);
+		regs = isx031_mode_regs(isx031);
+		phase = sensor_regseq_set_phase(&isx031->regseq,
+						SENSOR_REGSEQ_PHASE_MODE);
+		start = ktime_get();
+		ret = isx031_write_regs(isx031, regs, true);
+		sensor_regseq_trace_step(&isx031->regseq, "table-load", start,
+					 ret);
+		sensor_regseq_set_phase(&isx031->regseq, phase);
 		if (ret) {
 			dev_err(&client->dev, "Failed to set stream mode\n");
-			return ret;
+			/* Partially written, fall back to a full reload */
+			isx031->pre_mode = NULL;
+			goto out;
 		}
 		isx031->pre_mode = isx031->cur_mode;
 	}
 
+	start = ktime_get();
 	ret = __v4l2_ctrl_handler_setup(&isx031->ctrls);
+	sensor_regseq_trace_step(&isx031->regseq, "ctrl-setup", start, ret);
 	if (ret) {
 		dev_err(&client->dev, "Failed to setup controls\n");
-		return ret;
+		goto out;
 	}
 
+	phase = sensor_regseq_set_phase(&isx031->regseq,
+					SENSOR_REGSEQ_PHASE_STREAM_ON);
+	start = ktime_get();
 	ret = isx031_mode_transit(isx031, ISX031_STATE_STREAMING);
-	if (ret) {
+	sensor_regseq_trace_step(&isx031->regseq, "mode-set", start, ret);
+	sensor_regseq_set_phase(&isx031->regseq, phase);
+	if (ret)
 		dev_err(&client->dev, "Failed to start streaming\n");
-		return ret;
-	}
 
-	return 0;
+out:
+	sensor_regseq_trace_step(&isx031->regseq, "stream-on", begin, ret);
+
+	return ret;
 }
 
 static void isx031_stop_streaming(struct isx031 *isx031)
@@ -636,55 +636,103 @@ static void isx031_stop_streaming(struct isx031 *isx031)
 		dev_err(&client->dev, "Failed to stop streaming: %d\n", ret);
 }
 
-static int isx031_set_stream(struct v4l2_subdev *sd, int enable)
+/* Frame start events and FSIN pulses, while the sensor streams */
+static int isx031_sync_start(struct isx031 *isx031)
+{
+	int ret;
+
+	if (isx031->irq) {
+		isx031->frame_sequence = 0;
+		enable_irq(isx031->irq);
+	}
+
+	/* Trigger frames once the sensor waits for them */
+	ret = sensor_fsin_start(&isx031->fsin);
+	if (ret && isx031->irq)
+		disable_irq(isx031->irq);
+
+	return ret;
+}
+
+static void isx031_sync_stop(struct isx031 *isx031)
+{
+	sensor_fsin_stop(&isx031->fsin);
+
+	if (isx031->irq)
+		disable_irq(isx031->irq);
+}
+
+/* Called with the subdev active state (and control handler) lock held */
+static int __isx031_set_stream(struct isx031 *isx031, int enable)
 {
-	struct isx031 *isx031 = to_isx031(sd);
 	struct i2c_client *client = isx031->client;
 	int ret = 0;
 
-	mutex_lock(&isx031_mutex);
-
 	if (isx031->streaming == enable)
-		goto unlock;
+		return 0;
 
 	if (enable) {
+		/* The sensor may still be initializing after probe */
+		ret = wait_for_completion_killable(&isx031->init_done);
+		if (ret)
+			return ret;
+		if (isx031->init_ret)
+			return isx031->init_ret;
+		/* Lost on a failed resume, the sensor is not initialized */
+		if (!isx031->identified)
+			return -ENODEV;
+
 		ret = pm_runtime_resume_and_get(&client->dev);
 		if (ret < 0)
-			goto unlock;
+			return ret;
 
 		ret = isx031_start_streaming(isx031);
+		if (!ret)
+			ret = isx031_sync_start(isx031);
 		if (ret) {
 			isx031_stop_streaming(isx031);
 			pm_runtime_put(&client->dev);
-			goto unlock;
+			return ret;
 		}
 
 		isx031->streaming = true;
-
 	} else {
+		isx031_sync_stop(isx031);
 		isx031_stop_streaming(isx031);
-		pm_runtime_put(&client->dev);
+		pm_runtime_mark_last_busy(&client->dev);
+		pm_runtime_put_autosuspend(&client->dev);
 		isx031->streaming = false;
 	}
 
-unlock:
-	mutex_unlock(&isx031_mutex);
+	return 0;
+}
+
+static int isx031_set_stream(struct v4l2_subdev *sd, int enable)
+{
+	struct isx031 *isx031 = to_isx031(sd);
+	struct v4l2_subdev_state *state;
+	int ret;
+
+	state = v4l2_subdev_lock_and_get_active_state(sd);
+	ret = __isx031_set_stream(isx031, enable);
+	v4l2_subdev_unlock_state(state);
 
 	return ret;
 }
 
+/* The core holds the active state lock around these two */
 static int isx031_enable_streams(struct v4l2_subdev *subdev,
 				 struct v4l2_subdev_state *state,
 				 u32 pad, u64 streams_mask)
 {
-	return isx031_set_stream(subdev, true);
+	return __isx031_set_stream(to_isx031(subdev), true);
 }
 
 static int isx031_disable_streams(struct v4l2_subdev *subdev,
 				  struct v4l2_subdev_state *state,
 				  u32 pad, u64 streams_mask)
 {
-	return isx031_set_stream(subdev, false);
+	return __isx031_set_stream(to_isx031(subdev), false);
 }
 
 static int __maybe_unused isx031_suspend(struct device *dev)
@@ -692,73 +740,167 @@ static int __maybe_unused isx031_suspend(struct device *dev)
 	struct i2c_client *client = to_i2c_client(dev);
 	struct v4l2_subdev *sd = i2c_get_clientdata(client);
 	struct isx031 *isx031 = to_isx031(sd);
+	struct v4l2_subdev_state *state;
 
-	mutex_lock(&isx031_mutex);
+	flush_work(&isx031->init_work);
 
-	if (isx031->streaming)
+	state = v4l2_subdev_lock_and_get_active_state(sd);
+
+	if (isx031->streaming) {
+		isx031_sync_stop(isx031);
 		isx031_stop_streaming(isx031);
+	}
 
-	mutex_unlock(&isx031_mutex);
+	v4l2_subdev_unlock_state(state);
 
 	/* Active low gpio reset, set 1 to power off sensor */
-	if (isx031->reset_gpio)
+	if (isx031->reset_gpio) {
 		gpiod_set_value_cansleep(isx031->reset_gpio, 1);
+		isx031->powered_off = true;
+	}
 
 	return 0;
 }
 
-static int __maybe_unused isx031_resume(struct device *dev)
+/* Release reset and wait a fixed 200 ms per attempt for the sensor */
+static int isx031_power_on(struct isx031 *isx031)
 {
-	struct i2c_client *client = to_i2c_client(dev);
-	struct v4l2_subdev *sd = i2c_get_clientdata(client);
-	struct isx031 *isx031 = to_isx031(sd);
-	const struct isx031_reg_list *reg_list;
-	int ret;
 	int count;
+	int ret = 0;
 
-	mutex_lock(&isx031_mutex);
+	for (count = 0; count < ISX031_PM_RETRY_TIMEOUT; count++) {
+		gpiod_set_value_cansleep(isx031->reset_gpio, 0);
+		msleep(ISX031_REG_SLEEP_200MS);
 
-	/* Active low gpio reset, set 0 to power on sensor,
-	 * sensor must be on before resume
-	 */
-	if (isx031->reset_gpio) {
-		for (count = 0; count < ISX031_PM_RETRY_TIMEOUT; count++) {
-			gpiod_set_value_cansleep(isx031->reset_gpio, 0);
-			msleep(ISX031_REG_SLEEP_200MS);
+		ret = gpiod_get_value_cansleep(isx031->reset_gpio);
+		if (ret == 0)
+			break;
+	}
 
-			ret = gpiod_get_value_cansleep(isx031->reset_gpio);
-			if (ret == 0)
-				break;
-		}
+	return ret ? -ETIMEDOUT : 0;
+}
+
+/*
+ * Release reset and poll until the sensor answers in startup state, at
+ * state_poll_us granularity rather than sleeping 200 ms blindly. The sensor
+ * NAKs while it boots, the poll stays quiet and the caller reports once.
+ */
+static int isx031_power_on_fast(struct isx031 *isx031)
+{
+	gpiod_set_value_cansleep(isx031->reset_gpio, 0);
+
+	return sensor_regseq_poll(&isx031->regseq, ISX031_REG_SENSOR_STATE,
+				  ISX031_STATE_STARTUP, state_poll_us,
+				  ISX031_STATE_TIMEOUT_US);
+}
+
+/*
+ * Initialize a sensor that lost its registers. The cached values are dropped
+ * rather than synced: a sync would skip the init and framesync writes as
+ * cached and replay them in address order afterwards, while the vendor
+ * sequences must go out in their own order (0xBF14 first). The writes refill
+ * the cache, the mode table is reloaded in full on the next stream-on.
+ */
+static int isx031_reinit(struct isx031 *isx031)
+{
+	regcache_drop_region(isx031->regmap, 0,
+			     isx031_regmap_config.max_register);
+	isx031->pre_mode = NULL;
 
-		if (ret != 0) {
+	return isx031_initialize_module(isx031);
+}
+
+/*
+ * Bring the sensor out of the reset held by system suspend. The identity
+ * checked at probe still holds unless the sensor failed to come back, in
+ * which case fall back to the full power on and identify.
+ */
+static int isx031_power_up(struct isx031 *isx031)
+{
+	struct i2c_client *client = isx031->client;
+	ktime_t start;
+	bool fast;
+	int ret;
+
+	fast = fast_resume && isx031->identified;
+
+	/* Active low gpio reset, set 0 to power on sensor */
+	if (isx031->reset_gpio) {
+		start = ktime_get();
+		if (fast) {
+			ret = isx031_power_on_fast(isx031);
+			if (ret) {
+				dev_warn(&client->dev,
+					 "Sensor not up after reset: %d, doing a full resume\n",
+					 ret);
+				fast = false;
+			}
+		}
+		if (!fast)
+			ret = isx031_power_on(isx031);
+		sensor_regseq_trace_step(&isx031->regseq, "reset", start, ret);
+		if (ret) {
 			dev_err(&client->dev, "Failed to power on sensor in pm resume\n");
-			mutex_unlock(&isx031_mutex);
-			return -ETIMEDOUT;
+			return ret;
 		}
 	}
+	isx031->powered_off = false;
 
-	ret = isx031_identify_module(client);
-	if (ret) {
-		dev_err(&client->dev, "Failed to identify sensor module: %d\n", ret);
-		goto unlock;
+	if (!fast) {
+		start = ktime_get();
+		ret = isx031_identify_module(isx031);
+		sensor_regseq_trace_step(&isx031->regseq, "identify", start,
+					 ret);
+		if (ret) {
+			dev_err(&client->dev, "Failed to identify sensor module: %d\n", ret);
+			isx031->identified = false;
+			return ret;
+		}
+		isx031->identified = true;
 	}
 
-	ret = isx031_initialize_module(isx031);
-	if (ret) {
-		dev_err(&client->dev, "Failed to initialize sensor module: %d\n", ret);
+	return 0;
+}
+
+static int __maybe_unused isx031_resume(struct device *dev)
+{
+	struct i2c_client *client = to_i2c_client(dev);
+	struct v4l2_subdev *sd = i2c_get_clientdata(client);
+	struct isx031 *isx031 = to_isx031(sd);
+	enum sensor_regseq_phase phase;
+	struct v4l2_subdev_state *state;
+	ktime_t begin, start;
+	int ret;
+
+	/*
+	 * Left runtime suspended, the regmap is cache only and the sensor
+	 * stays in reset: runtime resume powers it up and initializes it.
+	 */
+	if (pm_runtime_suspended(dev))
+		return 0;
+
+	begin = ktime_get();
+	state = v4l2_subdev_lock_and_get_active_state(sd);
+	phase = sensor_regseq_set_phase(&isx031->regseq,
+					SENSOR_REGSEQ_PHASE_RESUME);
+
+	ret = isx031_power_up(isx031);
+	if (ret)
 		goto unlock;
-	}
 
-	reg_list = &isx031->cur_mode->reg_list;
-	ret = isx031_write_reg_list(client, reg_list, true);
+	start = ktime_get();
+	ret = isx031_reinit(isx031);
+	sensor_regseq_trace_step(&isx031->regseq, "init", start, ret);
 	if (ret) {
-		dev_err(&client->dev, "Failed to apply cur mode in resume: %d\n", ret);
+		dev_err(&client->dev, "Failed to initialize sensor module: %d\n", ret);
 		goto unlock;
 	}
+	isx031->init_ret = 0;
 
 	if (isx031->streaming) {
 		ret = isx031_start_streaming(isx031);
+		if (!ret)
+			ret = isx031_sync_start(isx031);
 		if (ret) {
 			isx031->streaming = false;
 			isx031_stop_streaming(isx031);
@@ -767,7 +909,59 @@ static int __maybe_unused isx031_resume(struct device *dev)
 	}
 
 unlock:
-	mutex_unlock(&isx031_mutex);
+	sensor_regseq_set_phase(&isx031->regseq, phase);
+	v4l2_subdev_unlock_state(state);
+	sensor_regseq_trace_step(&isx031->regseq, "resume", begin, ret);
+
+	return ret;
+}
+
+/*
+ * The power domain may cut power, force a full reload on next start. Writes
+ * meanwhile only land in the cache, the registers are re-read or rewritten
+ * on resume.
+ */
+static int __maybe_unused isx031_runtime_suspend(struct device *dev)
+{
+	struct isx031 *isx031 = to_isx031(dev_get_drvdata(dev));
+
+	isx031->pre_mode = NULL;
+	regcache_cache_only(isx031->regmap, true);
+	regcache_mark_dirty(isx031->regmap);
+
+	return 0;
+}
+
+static int __maybe_unused isx031_runtime_resume(struct device *dev)
+{
+	struct isx031 *isx031 = to_isx031(dev_get_drvdata(dev));
+	enum sensor_regseq_phase phase;
+	int ret;
+
+	regcache_cache_only(isx031->regmap, false);
+
+	phase = sensor_regseq_set_phase(&isx031->regseq,
+					SENSOR_REGSEQ_PHASE_RESUME);
+
+	/* Still in the reset of a system suspend entered runtime suspended */
+	if (isx031->powered_off) {
+		ret = isx031_power_up(isx031);
+		if (ret)
+			goto out;
+	}
+
+	/* Nothing to restore if probe never got the sensor going */
+	if (!isx031->identified) {
+		ret = 0;
+		goto out;
+	}
+
+	ret = isx031_reinit(isx031);
+out:
+	sensor_regseq_set_phase(&isx031->regseq, phase);
+	if (ret)
+		dev_err(dev, "Failed to initialize sensor in runtime resume: %d\n",
+			ret);
 
 	return ret;
 }
@@ -810,28 +1004,15 @@ static int isx031_get_frame_desc(struct v4l2_subdev *sd,
 #endif
 
 static int isx031_set_format(struct v4l2_subdev *sd,
-#if LINUX_VERSION_CODE < KERNEL_VERSION(5, 14, 0)
-			     struct v4l2_subdev_pad_config *cfg,
-#else
 			     struct v4l2_subdev_state *sd_state,
-#endif
 			     struct v4l2_subdev_format *fmt)
 {
 	struct isx031 *isx031 = to_isx031(sd);
-	const struct isx031_mode *mode = NULL;
-	unsigned int i;
-
-	mutex_lock(&isx031_mutex);
+	const struct isx031_mode *mode;
 
-	/* Find the best matching mode */
-	for (i = 0; i < ARRAY_SIZE(supported_modes); i++) {
-		if (supported_modes[i].code == fmt->format.code &&
-			supported_modes[i].width == fmt->format.width &&
-			supported_modes[i].height == fmt->format.height) {
-			mode = &supported_modes[i];
-			break;
-		}
-	}
+	/* Find the best matching mode, keeping the current frame rate */
+	mode = isx031_find_mode(isx031, fmt->format.code, fmt->format.width,
+				fmt->format.height, isx031->cur_mode->fps);
 
 	/* If no exact match, use the default mode */
 	if (!mode)
@@ -840,9 +1021,7 @@ static int isx031_set_format(struct v4l2_subdev *sd,
 	isx031_update_pad_format(mode, &fmt->format);
 
 	if (fmt->which == V4L2_SUBDEV_FORMAT_TRY)
-#if LINUX_VERSION_CODE < KERNEL_VERSION(5, 14, 0)
-		*v4l2_subdev_get_try_format(sd, cfg, fmt->pad) = fmt->format;
-#elif LINUX_VERSION_CODE < KERNEL_VERSION(6, 8, 0)
+#if LINUX_VERSION_CODE < KERNEL_VERSION(6, 8, 0)
 		*v4l2_subdev_get_try_format(sd, sd_state, fmt->pad) = fmt->format;
 #else
 		*v4l2_subdev_state_get_format(sd_state, fmt->pad) = fmt->format;
@@ -850,28 +1029,122 @@ static int isx031_set_format(struct v4l2_subdev *sd,
 	else
 		isx031->cur_mode = mode;
 
-	mutex_unlock(&isx031_mutex);
+	return 0;
+}
+
+static int isx031_enum_frame_interval(struct v4l2_subdev *sd,
+				      struct v4l2_subdev_state *sd_state,
+				      struct v4l2_subdev_frame_interval_enum *fie)
+{
+	struct isx031 *isx031 = to_isx031(sd);
+	const struct isx031_mode *mode;
+	unsigned int i, index = 0;
+
+	for (i = 0; i < ARRAY_SIZE(supported_modes); i++) {
+		mode = &supported_modes[i];
+		if (mode->code != fie->code || mode->width != fie->width ||
+		    mode->height != fie->height ||
+		    !isx031_mode_supported(isx031, mode))
+			continue;
+
+		if (index++ == fie->index) {
+			fie->interval.numerator = 1;
+			fie->interval.denominator = mode->fps;
+			return 0;
+		}
+	}
+
+	return -EINVAL;
+}
+
+static void __isx031_get_frame_interval(struct isx031 *isx031,
+					struct v4l2_fract *interval)
+{
+	interval->numerator = 1;
+	interval->denominator = isx031->cur_mode->fps;
+}
+
+/* Switch to the frame rate closest to @interval at the current size */
+static int __isx031_set_frame_interval(struct isx031 *isx031,
+				       struct v4l2_fract *interval)
+{
+	const struct isx031_mode *cur = isx031->cur_mode, *mode;
+	u32 fps = cur->fps;
+
+	if (isx031->streaming)
+		return -EBUSY;
+
+	if (interval->numerator && interval->denominator)
+		fps = DIV_ROUND_CLOSEST(interval->denominator,
+					interval->numerator);
+
+	mode = isx031_find_mode(isx031, cur->code, cur->width, cur->height,
+				fps);
+	if (mode)
+		isx031->cur_mode = mode;
+
+	__isx031_get_frame_interval(isx031, interval);
 
 	return 0;
 }
 
-static int isx031_get_format(struct v4l2_subdev *sd,
-#if LINUX_VERSION_CODE < KERNEL_VERSION(5, 14, 0)
-			     struct v4l2_subdev_pad_config *cfg,
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 8, 0)
+static int isx031_get_frame_interval(struct v4l2_subdev *sd,
+				     struct v4l2_subdev_state *sd_state,
+				     struct v4l2_subdev_frame_interval *fi)
+{
+	if (fi->which != V4L2_SUBDEV_FORMAT_ACTIVE)
+		return -EINVAL;
+
+	__isx031_get_frame_interval(to_isx031(sd), &fi->interval);
+
+	return 0;
+}
+
+static int isx031_set_frame_interval(struct v4l2_subdev *sd,
+				     struct v4l2_subdev_state *sd_state,
+				     struct v4l2_subdev_frame_interval *fi)
+{
+	if (fi->which != V4L2_SUBDEV_FORMAT_ACTIVE)
+		return -EINVAL;
+
+	return __isx031_set_frame_interval(to_isx031(sd), &fi->interval);
+}
 #else
-			     struct v4l2_subdev_state *sd_state,
+static int isx031_g_frame_interval(struct v4l2_subdev *sd,
+				   struct v4l2_subdev_frame_interval *fi)
+{
+	struct v4l2_subdev_state *state;
+
+	state = v4l2_subdev_lock_and_get_active_state(sd);
+	__isx031_get_frame_interval(to_isx031(sd), &fi->interval);
+	v4l2_subdev_unlock_state(state);
+
+	return 0;
+}
+
+static int isx031_s_frame_interval(struct v4l2_subdev *sd,
+				   struct v4l2_subdev_frame_interval *fi)
+{
+	struct v4l2_subdev_state *state;
+	int ret;
+
+	state = v4l2_subdev_lock_and_get_active_state(sd);
+	ret = __isx031_set_frame_interval(to_isx031(sd), &fi->interval);
+	v4l2_subdev_unlock_state(state);
+
+	return ret;
+}
 #endif
+
+static int isx031_get_format(struct v4l2_subdev *sd,
+			     struct v4l2_subdev_state *sd_state,
 			     struct v4l2_subdev_format *fmt)
 {
 	struct isx031 *isx031 = to_isx031(sd);
 
-	mutex_lock(&isx031_mutex);
-
 	if (fmt->which == V4L2_SUBDEV_FORMAT_TRY)
-#if LINUX_VERSION_CODE < KERNEL_VERSION(5, 14, 0)
-		fmt->format = *v4l2_subdev_get_try_format(&isx031->sd, cfg,
-							  fmt->pad);
-#elif LINUX_VERSION_CODE < KERNEL_VERSION(6, 8, 0)
+#if LINUX_VERSION_CODE < KERNEL_VERSION(6, 8, 0)
 		fmt->format = *v4l2_subdev_get_try_format(&isx031->sd, sd_state,
 							  fmt->pad);
 #else
@@ -880,19 +1153,12 @@ static int isx031_get_format(struct v4l2_subdev *sd,
 	else
 		isx031_update_pad_format(isx031->cur_mode, &fmt->format);
 
-	mutex_unlock(&isx031_mutex);
-
 	return 0;
 }
 
 static int isx031_open(struct v4l2_subdev *sd, struct v4l2_subdev_fh *fh)
 {
-	mutex_lock(&isx031_mutex);
-
-#if LINUX_VERSION_CODE < KERNEL_VERSION(5, 14, 0)
-	isx031_update_pad_format(&supported_modes[0],
-				 v4l2_subdev_get_try_format(sd, fh->pad, 0));
-#elif LINUX_VERSION_CODE < KERNEL_VERSION(6, 8, 0)
+#if LINUX_VERSION_CODE < KERNEL_VERSION(6, 8, 0)
 	isx031_update_pad_format(&supported_modes[0],
 				 v4l2_subdev_get_try_format(sd, fh->state, 0));
 #else
@@ -900,24 +1166,51 @@ static int isx031_open(struct v4l2_subdev *sd, struct v4l2_subdev_fh *fh)
 				 v4l2_subdev_state_get_format(fh->state, 0));
 #endif
 
-	mutex_unlock(&isx031_mutex);
-
 	return 0;
 }
 
+static int isx031_subscribe_event(struct v4l2_subdev *sd, struct v4l2_fh *fh,
+				  struct v4l2_event_subscription *sub)
+{
+	switch (sub->type) {
+	case V4L2_EVENT_FRAME_SYNC:
+		if (!to_isx031(sd)->irq)
+			return -EINVAL;
+		return v4l2_event_subscribe(fh, sub, ISX031_FRAME_SYNC_EVENTS,
+					    NULL);
+	default:
+		return v4l2_ctrl_subdev_subscribe_event(sd, fh, sub);
+	}
+}
+
+static const struct v4l2_subdev_core_ops isx031_core_ops = {
+	.subscribe_event = isx031_subscribe_event,
+	.unsubscribe_event = v4l2_event_subdev_unsubscribe,
+};
+
 static const struct v4l2_subdev_video_ops isx031_video_ops = {
 	.s_stream = isx031_set_stream,
+#if LINUX_VERSION_CODE < KERNEL_VERSION(6, 8, 0)
+	.g_frame_interval = isx031_g_frame_interval,
+	.s_frame_interval = isx031_s_frame_interval,
+#endif
 };
 
 static const struct v4l2_subdev_pad_ops isx031_pad_ops = {
 	.set_fmt = isx031_set_format,
 	.get_fmt = isx031_get_format,
+	.enum_frame_interval = isx031_enum_frame_interval,
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 8, 0)
+	.get_frame_interval = isx031_get_frame_interval,
+	.set_frame_interval = isx031_set_frame_interval,
+#endif
 	.get_frame_desc = isx031_get_frame_desc,
 	.enable_streams = isx031_enable_streams,
 	.disable_streams = isx031_disable_streams,
 };
 
 static const struct v4l2_subdev_ops isx031_subdev_ops = {
+	.core = &isx031_core_ops,
 	.video = &isx031_video_ops,
 	.pad = &isx031_pad_ops,
 };
@@ -941,52 +1234,213 @@ static const struct v4l2_ctrl_ops isx031_ctrl_ops = {
 
 static int isx031_ctrls_init(struct isx031 *sensor)
 {
-	struct v4l2_ctrl *ctrl;
 	struct v4l2_ctrl_handler *hdl = &sensor->ctrls;
+	s64 pixel_rate = isx031_pixel_rate(sensor);
 
 	v4l2_ctrl_handler_init(hdl, 10);
 
 	/* There's a need to set the link frequency because IPU6 dictates it. */
-	ctrl = v4l2_ctrl_new_int_menu(hdl, &isx031_ctrl_ops,
-				      V4L2_CID_LINK_FREQ,
-				      ARRAY_SIZE(isx031_link_frequencies) - 1, 0,
-				      isx031_link_frequencies);
+	sensor->link_freq =
+		v4l2_ctrl_new_int_menu(hdl, &isx031_ctrl_ops,
+				       V4L2_CID_LINK_FREQ,
+				       ARRAY_SIZE(isx031_link_frequencies) - 1,
+				       0, isx031_link_frequencies);
+
+	sensor->pixel_rate = v4l2_ctrl_new_std(hdl, &isx031_ctrl_ops,
+					       V4L2_CID_PIXEL_RATE, pixel_rate,
+					       pixel_rate, 1, pixel_rate);
 
 	if (hdl->error) {
 		v4l2_ctrl_handler_free(hdl);
 		return hdl->error;
 	}
 
-	if (ctrl)
-		ctrl->flags |= V4L2_CTRL_FLAG_READ_ONLY;
+	sensor->link_freq->flags |= V4L2_CTRL_FLAG_READ_ONLY;
+	sensor->pixel_rate->flags |= V4L2_CTRL_FLAG_READ_ONLY;
 
 	sensor->sd.ctrl_handler = hdl;
 
 	return 0;
 }
 
-#if LINUX_VERSION_CODE < KERNEL_VERSION(6, 1, 0)
-static int isx031_remove(struct i2c_client *client)
-#else
 static void isx031_remove(struct i2c_client *client)
-#endif
 {
 	struct v4l2_subdev *sd = i2c_get_clientdata(client);
+	struct isx031 *isx031 = to_isx031(sd);
 
 	v4l2_async_unregister_subdev(sd);
+	flush_work(&isx031->init_work);
 	media_entity_cleanup(&sd->entity);
+	pm_runtime_dont_use_autosuspend(&client->dev);
 	pm_runtime_disable(&client->dev);
+}
+
+/*
+ * After a kexec or a driver reload the sensor may still hold the current
+ * mode, possibly streaming. Return that mode if the live framesync, mode
+ * table and drive mode registers all match, NULL otherwise. A streaming
+ * sensor is brought back to startup state, as after a fresh init. The
+ * registers are read past the regcache, a fallback re-init writes the
+ * tables in full.
+ */
+static const struct isx031_mode *isx031_adopt(struct isx031 *isx031)
+{
+	struct i2c_client *client = isx031->client;
+	const struct isx031_mode *mode = isx031->cur_mode;
+	u64 state = 0, drive_mode = 0;
+	int ret;
+
+	ret = isx031_read_reg_state(isx031, &state);
+	if (ret || (state != ISX031_STATE_STARTUP &&
+		    state != ISX031_STATE_STREAMING))
+		return NULL;
+
+	if (isx031->platform_data &&
+	    !isx031->platform_data->irq_pin_flags &&
+	    sensor_regseq_verify_blob(&isx031->regseq,
+				      &isx031_framesync_regs) != 1)
+		return NULL;
+
+	ret = sensor_regseq_read(&isx031->regseq, ISX031_REG_MODE_SELECT,
+				 &drive_mode, NULL);
+	if (ret)
+		return NULL;
+
+	/* Modes sharing a geometry table differ in the drive mode only */
+	if (drive_mode != isx031_find_drive_mode(isx031->lanes, mode->fps) ||
+	    sensor_regseq_verify_blob(&isx031->regseq, mode->regs) != 1)
+		return NULL;
+
+	/* Only stream-on starts streaming */
+	if (state == ISX031_STATE_STREAMING &&
+	    isx031_mode_transit(isx031, ISX031_STATE_STARTUP))
+		return NULL;
+
+	dev_info(&client->dev, "Adopted %ux%u@%u mode%s\n",
+		 mode->width, mode->height, mode->fps,
+		 state == ISX031_STATE_STREAMING ? ", stopped streaming" : "");
+
+	return mode;
+}
+
+/*
+ * Frame start from the sensor. The event core timestamps the event with
+ * CLOCK_MONOTONIC when it is queued, so this runs in hard interrupt
+ * context unless the GPIO controller needs a thread.
+ */
+static irqreturn_t isx031_irq(int irq, void *data)
+{
+	struct isx031 *isx031 = data;
+	struct v4l2_event event = {
+		.type = V4L2_EVENT_FRAME_SYNC,
+		.u.frame_sync.frame_sequence = isx031->frame_sequence++,
+	};
+
+	v4l2_event_queue(isx031->sd.devnode, &event);
+
+	return IRQ_HANDLED;
+}
+
+/*
+ * The frame start interrupt comes from the "irq" GPIO of the firmware node
+ * or of a board GPIO lookup table, with the trigger in irq_pin_flags. The
+ * driver does not route the sensor's frame start to a pin: the board has
+ * to wire that pin to a sensor (or serializer) output which already
+ * carries it. A non-zero irq_pin_flags also keeps the framesync table,
+ * which sets the sensor pins to Hi-Z, from being written, see
+ * __isx031_initialize_module(). The interrupt stays disabled until the
+ * sensor streams.
+ */
+static int isx031_irq_init(struct isx031 *isx031)
+{
+	struct isx031_platform_data *pdata = isx031->platform_data;
+	struct device *dev = &isx031->client->dev;
+	struct gpio_desc *gpio;
+	int irq, ret;
+
+	if (!pdata || !pdata->irq_pin_flags)
+		return 0;
+
+	gpio = devm_gpiod_get_optional(dev, "irq", GPIOD_IN);
+	if (IS_ERR(gpio))
+		return dev_err_probe(dev, PTR_ERR(gpio),
+				     "Failed to get irq gpio\n");
+	if (!gpio)
+		return 0;
+	if (pdata->irq_pin_name[0])
+		gpiod_set_consumer_name(gpio, pdata->irq_pin_name);
+
+	irq = gpiod_to_irq(gpio);
+	if (irq < 0) {
+		dev_err(dev, "No interrupt for irq gpio: %d\n", irq);
+		return irq;
+	}
+
+	ret = devm_request_any_context_irq(dev, irq, isx031_irq,
+					   pdata->irq_pin_flags,
+					   dev_name(dev), isx031);
+	if (ret < 0) {
+		dev_err(dev, "Failed to request irq %d: %d\n", irq, ret);
+		return ret;
+	}
+	disable_irq(irq);
+	isx031->irq = irq;
 
-#if LINUX_VERSION_CODE < KERNEL_VERSION(6, 1, 0)
 	return 0;
-#endif
+}
+
+static void isx031_init_work(struct work_struct *work)
+{
+	struct isx031 *isx031 = container_of(work, struct isx031, init_work);
+	struct i2c_client *client = isx031->client;
+	const struct isx031_mode *mode = &supported_modes[0];
+	int ret;
+
+	ret = isx031_identify_module(isx031);
+	if (ret) {
+		dev_err(&client->dev, "Failed to identify sensor module: %d\n", ret);
+		goto out;
+	}
+	isx031->identified = true;
+
+	if (adopt) {
+		mode = isx031_adopt(isx031);
+		if (mode) {
+			/* Keep the programmed mode, only refresh the init table */
+			ret = isx031_write_regs(isx031, &isx031_init_regs, true);
+			if (!ret)
+				isx031->pre_mode = mode;
+			goto out;
+		}
+		mode = &supported_modes[0];
+	}
+
+	ret = isx031_initialize_module(isx031);
+	if (ret) {
+		dev_err(&client->dev, "Failed to initialize sensor: %d\n", ret);
+		goto out;
+	}
+
+	ret = isx031_write_regs(isx031, mode->regs, true);
+	if (ret) {
+		dev_err(&client->dev, "Failed to apply preset mode\n");
+		goto out;
+	}
+	isx031->pre_mode = mode;
+
+out:
+	isx031->init_ret = ret;
+	sensor_regseq_set_phase(&isx031->regseq, SENSOR_REGSEQ_PHASE_OTHER);
+	complete_all(&isx031->init_done);
+
+	pm_runtime_mark_last_busy(&client->dev);
+	pm_runtime_put_autosuspend(&client->dev);
 }
 
 static int isx031_probe(struct i2c_client *client)
 {
 	struct v4l2_subdev *sd;
 	struct isx031 *isx031;
-	const struct isx031_reg_list *reg_list;
 	int ret;
 
 	isx031 = devm_kzalloc(&client->dev, sizeof(*isx031), GFP_KERNEL);
@@ -998,6 +1452,9 @@ static int isx031_probe(struct i2c_client *client)
 	if (!isx031->platform_data)
 		dev_warn(&client->dev, "No platform data provided\n");
 
+	INIT_WORK(&isx031->init_work, isx031_init_work);
+	init_completion(&isx031->init_done);
+
 	isx031->reset_gpio = devm_gpiod_get_optional(&client->dev, "reset",
 							 GPIOD_OUT_LOW);
 	if (IS_ERR(isx031->reset_gpio))
@@ -1007,13 +1464,48 @@ static int isx031_probe(struct i2c_client *client)
 	else
 		dev_warn(&client->dev, "Reset gpio not found\n");
 
+	isx031->regmap = devm_regmap_init_i2c(client, &isx031_regmap_config);
+	if (IS_ERR(isx031->regmap))
+		return dev_err_probe(&client->dev, PTR_ERR(isx031->regmap),
+				     "Failed to init regmap\n");
+	sensor_regseq_init(&isx031->regseq, &client->dev, isx031->regmap);
+	ret = sensor_regseq_debugfs_init(&isx031->regseq);
+	if (ret)
+		return ret;
+
 	isx031->fsin_gpio = devm_gpiod_get_optional(&client->dev, "fsin",
 						    GPIOD_OUT_LOW);
+	if (IS_ERR(isx031->fsin_gpio))
+		return dev_err_probe(&client->dev, PTR_ERR(isx031->fsin_gpio),
+				     "Failed to get fsin gpio\n");
 	if (isx031->fsin_gpio)
 		dev_info(&client->dev, "Fsin gpio found\n");
 	else
 		dev_warn(&client->dev, "Fsin gpio not found\n");
 
+	ret = sensor_fsin_init(&isx031->fsin, &client->dev, isx031->fsin_gpio);
+	if (ret)
+		return ret;
+
+	ret = isx031_irq_init(isx031);
+	if (ret)
+		return ret;
+
+	if (isx031->platform_data && isx031->platform_data->lanes)
+		isx031->lanes = isx031->platform_data->lanes;
+	else {
+		/* Read info from fwnode entrypoint bus cfg if no platform data */
+		ret = isx031_get_num_lane(isx031, &client->dev);
+		if (ret) {
+			dev_err(&client->dev, "Failed to get mipi lane configuration\n");
+			return ret;
+		}
+	}
+
+	/* 1920x1536 default */
+	isx031->pre_mode = NULL;
+	isx031->cur_mode = &supported_modes[0];
+
 	/* Initialize subdevice */
 	sd = &isx031->sd;
 	v4l2_i2c_subdev_init(sd, client, &isx031_subdev_ops);
@@ -1024,11 +1516,7 @@ static int isx031_probe(struct i2c_client *client)
 		return ret;
 	}
 
-#if LINUX_VERSION_CODE < KERNEL_VERSION(6, 10, 0)
 	sd->flags |= V4L2_SUBDEV_FL_HAS_DEVNODE | V4L2_SUBDEV_FL_HAS_EVENTS;
-#else
-	sd->flags |= V4L2_SUBDEV_FL_HAS_DEVNODE;
-#endif
 	sd->internal_ops = &isx031_internal_ops;
 	sd->entity.ops = &isx031_subdev_entity_ops;
 	sd->entity.function = MEDIA_ENT_F_CAM_SENSOR;
@@ -1048,61 +1536,41 @@ static int isx031_probe(struct i2c_client *client)
 		snprintf(isx031->sd.name, sizeof(isx031->sd.name), "isx031 %s",
 			 isx031->platform_data->suffix);
 
-	if (isx031->platform_data && isx031->platform_data->lanes)
-		isx031->lanes = isx031->platform_data->lanes;
-	else {
-		/* Read info from fwnode entrypoint bus cfg if no platform data */
-		ret = isx031_get_num_lane(isx031, &client->dev);
-		if (ret) {
-			dev_err(&client->dev, "Failed to get mipi lane configuration\n");
-			goto err_media_cleanup;
-		}
-	}
-
-	ret = isx031_identify_module(client);
-	if (ret) {
-		dev_err(&client->dev, "Failed to identify sensor module: %d\n", ret);
-		goto err_media_cleanup;
-	}
-
-	/* 1920x1536 default */
-	isx031->pre_mode = NULL;
-	isx031->cur_mode = &supported_modes[0];
-	ret = isx031_initialize_module(isx031);
-	if (ret) {
-		dev_err(&client->dev, "Failed to initialize sensor: %d\n", ret);
-		goto err_media_cleanup;
-	}
+	/*
+	 * Device is already turned on by i2c-core with ACPI domain PM.
+	 * Enable runtime PM and turn off the device once the autosuspend
+	 * delay expired. Powered up, the sensor keeps the programmed mode.
+	 */
+	pm_runtime_set_active(&client->dev);
+	pm_runtime_get_noresume(&client->dev);
+	pm_runtime_set_autosuspend_delay(&client->dev,
+					 ISX031_AUTOSUSPEND_DELAY_MS);
+	pm_runtime_use_autosuspend(&client->dev);
+	pm_runtime_enable(&client->dev);
 
-	reg_list = &isx031->cur_mode->reg_list;
-	ret = isx031_write_reg_list(client, reg_list, true);
-	if (ret) {
-		dev_err(&client->dev, "Failed to apply preset mode\n");
-		goto err_media_cleanup;
-	}
-	isx031->pre_mode = isx031->cur_mode;
+	/*
+	 * Identify and initialize the sensor in the background, the OTP
+	 * reads alone may retry for hundreds of ms. Stream-on waits for it.
+	 * The work holds the runtime PM reference taken above, so the sensor
+	 * stays powered until it is done.
+	 */
+	queue_work(system_unbound_wq, &isx031->init_work);
 
-#if LINUX_VERSION_CODE < KERNEL_VERSION(5, 13, 0)
-	ret = v4l2_async_register_subdev_sensor_common(&isx031->sd);
-#else
+	/* Last, the subdev can be opened and streamed from here on */
 	ret = v4l2_async_register_subdev_sensor(&isx031->sd);
-#endif
 	if (ret) {
 		dev_err(&client->dev, "Failed to register V4L2 subdev: %d\n", ret);
-		goto err_media_cleanup;
+		goto err_pm;
 	}
 
-	/*
-	 * Device is already turned on by i2c-core with ACPI domain PM.
-	 * Enable runtime PM and turn off the device.
-	 */
-	pm_runtime_set_active(&client->dev);
-	pm_runtime_enable(&client->dev);
-	pm_runtime_idle(&client->dev);
-
 	return 0;
 
-err_media_cleanup:
+err_pm:
+	/* The work drops the runtime PM reference when done */
+	flush_work(&isx031->init_work);
+	pm_runtime_disable(&client->dev);
+	pm_runtime_set_suspended(&client->dev);
+	pm_runtime_dont_use_autosuspend(&client->dev);
 	media_entity_cleanup(&isx031->sd.entity);
 err_ctrl_free:
 	v4l2_ctrl_handler_free(isx031->sd.ctrl_handler);
@@ -1110,8 +1578,35 @@ err_ctrl_free:
 	return ret;
 }
 
+static ssize_t startup_transit_us_show(struct device *dev,
+				       struct device_attribute *attr, char *buf)
+{
+	struct isx031 *isx031 = to_isx031(dev_get_drvdata(dev));
+
+	return sysfs_emit(buf, "%u\n", isx031->startup_transit_us);
+}
+static DEVICE_ATTR_RO(startup_transit_us);
+
+static ssize_t streaming_transit_us_show(struct device *dev,
+					 struct device_attribute *attr,
+					 char *buf)
+{
+	struct isx031 *isx031 = to_isx031(dev_get_drvdata(dev));
+
+	return sysfs_emit(buf, "%u\n", isx031->streaming_transit_us);
+}
+static DEVICE_ATTR_RO(streaming_transit_us);
+
+static struct attribute *isx031_attrs[] = {
+	&dev_attr_startup_transit_us.attr,
+	&dev_attr_streaming_transit_us.attr,
+	NULL
+};
+ATTRIBUTE_GROUPS(isx031);
+
 static const struct dev_pm_ops isx031_pm_ops = {
 	SET_SYSTEM_SLEEP_PM_OPS(isx031_suspend, isx031_resume)
+	SET_RUNTIME_PM_OPS(isx031_runtime_suspend, isx031_runtime_resume, NULL)
 };
 
 static const struct i2c_device_id isx031_id_table[] = {
@@ -1131,13 +1626,11 @@ static struct i2c_driver isx031_i2c_driver = {
 	.driver = {
 		.name = "isx031",
 		.acpi_match_table = ACPI_PTR(isx031_acpi_ids),
+		.probe_type = PROBE_PREFER_ASYNCHRONOUS,
 		.pm = &isx031_pm_ops,
+		.dev_groups = isx031_groups,
 	},
-#if LINUX_VERSION_CODE < KERNEL_VERSION(6, 6, 0)
-	.probe_new = isx031_probe,
-#else
 	.probe = isx031_probe,
-#endif
 	.remove = isx031_remove,
 	.id_table = isx031_id_table,
 };
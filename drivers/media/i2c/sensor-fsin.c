@@ -0,0 +1,238 @@
+// SPDX-License-Identifier: GPL-2.0
+// Copyright (c) 2025 Intel Corporation.
+
+#include <linux/device.h>
+#include <linux/gpio/consumer.h>
+#include <linux/hrtimer.h>
+#include <linux/ktime.h>
+#include <linux/math64.h>
+#include <linux/module.h>
+#include <linux/mutex.h>
+#include <linux/property.h>
+#include <linux/version.h>
+
+#include "media/sensor-fsin.h"
+
+/* Pulses are toggled from hard interrupt context, keep their rate sane */
+#define SENSOR_FSIN_MAX_RATE_HZ		1000
+
+static unsigned int rate_hz;
+static unsigned int pulse_us = 100;
+
+/* The pulse must end within the period, or the line never drops */
+static int sensor_fsin_check(unsigned int rate, unsigned int pulse)
+{
+	if (rate > SENSOR_FSIN_MAX_RATE_HZ)
+		return -EINVAL;
+	if (rate && (!pulse || (u64)pulse * rate >= USEC_PER_SEC))
+		return -EINVAL;
+
+	return 0;
+}
+
+static int sensor_fsin_set_rate(const char *val, const struct kernel_param *kp)
+{
+	unsigned int rate;
+	int ret;
+
+	ret = kstrtouint(val, 0, &rate);
+	if (ret)
+		return ret;
+
+	ret = sensor_fsin_check(rate, pulse_us);
+	if (ret)
+		return ret;
+
+	return param_set_uint(val, kp);
+}
+
+static int sensor_fsin_set_pulse(const char *val, const struct kernel_param *kp)
+{
+	unsigned int pulse;
+	int ret;
+
+	ret = kstrtouint(val, 0, &pulse);
+	if (ret)
+		return ret;
+
+	ret = sensor_fsin_check(rate_hz, pulse);
+	if (ret)
+		return ret;
+
+	return param_set_uint(val, kp);
+}
+
+static const struct kernel_param_ops sensor_fsin_rate_ops = {
+	.set = sensor_fsin_set_rate,
+	.get = param_get_uint,
+};
+
+static const struct kernel_param_ops sensor_fsin_pulse_ops = {
+	.set = sensor_fsin_set_pulse,
+	.get = param_get_uint,
+};
+
+module_param_cb(rate_hz, &sensor_fsin_rate_ops, &rate_hz, 0644);
+MODULE_PARM_DESC(rate_hz,
+		 "FSIN pulse rate, 0 disables the generator (Hz, up to 1000, applied when no sensor streams)");
+
+module_param_cb(pulse_us, &sensor_fsin_pulse_ops, &pulse_us, 0644);
+MODULE_PARM_DESC(pulse_us,
+		 "FSIN pulse width, shorter than the period (us, applied when no sensor streams)");
+
+/* Time base shared by all running generators, protected by the lock */
+static DEFINE_MUTEX(sensor_fsin_lock);
+static unsigned int sensor_fsin_users;
+static ktime_t sensor_fsin_epoch;
+static ktime_t sensor_fsin_period;
+static ktime_t sensor_fsin_width;
+
+/* First rising edge at or after @now, skipping missed periods */
+static ktime_t sensor_fsin_next_edge(struct sensor_fsin *fsin, ktime_t edge,
+				     ktime_t now)
+{
+	u64 periods;
+
+	if (ktime_after(edge, now))
+		return edge;
+
+	periods = div64_u64(ktime_to_ns(ktime_sub(now, edge)),
+			    ktime_to_ns(fsin->period)) + 1;
+
+	return ktime_add_ns(edge, periods * ktime_to_ns(fsin->period));
+}
+
+static enum hrtimer_restart sensor_fsin_timer(struct hrtimer *timer)
+{
+	struct sensor_fsin *fsin = container_of(timer, struct sensor_fsin,
+						timer);
+
+	fsin->high = !fsin->high;
+	gpiod_set_value(fsin->gpio, fsin->high);
+
+	if (fsin->high) {
+		hrtimer_set_expires(timer, ktime_add(fsin->next, fsin->width));
+	} else {
+		fsin->next = sensor_fsin_next_edge(fsin,
+						   ktime_add(fsin->next,
+							     fsin->period),
+						   ktime_get());
+		hrtimer_set_expires(timer, fsin->next);
+	}
+
+	return HRTIMER_RESTART;
+}
+
+static void sensor_fsin_release(void *data)
+{
+	sensor_fsin_stop(data);
+}
+
+/*
+ * Set up the generator for @gpio, which may be NULL. The phase comes from
+ * the optional "fsin-phase-us" device property.
+ */
+int sensor_fsin_init(struct sensor_fsin *fsin, struct device *dev,
+		     struct gpio_desc *gpio)
+{
+	u32 phase_us = 0;
+
+	fsin->dev = dev;
+	fsin->gpio = gpio;
+	fsin->running = false;
+
+	device_property_read_u32(dev, "fsin-phase-us", &phase_us);
+	fsin->phase_ns = (u64)phase_us * NSEC_PER_USEC;
+
+#if LINUX_VERSION_CODE < KERNEL_VERSION(6, 13, 0)
+	hrtimer_init(&fsin->timer, CLOCK_MONOTONIC, HRTIMER_MODE_ABS);
+	fsin->timer.function = sensor_fsin_timer;
+#else
+	hrtimer_setup(&fsin->timer, sensor_fsin_timer, CLOCK_MONOTONIC,
+		      HRTIMER_MODE_ABS);
+#endif
+
+	return devm_add_action_or_reset(dev, sensor_fsin_release, fsin);
+}
+EXPORT_SYMBOL_GPL(sensor_fsin_init);
+
+/*
+ * Start pulsing, joining the time base of the generators already running.
+ * Does nothing without a GPIO or while the rate_hz parameter is 0. Pulses
+ * are toggled from hard interrupt context, a GPIO that can sleep fails
+ * with -EOPNOTSUPP once a rate is set.
+ */
+int sensor_fsin_start(struct sensor_fsin *fsin)
+{
+	unsigned int rate, pulse;
+	u64 period, phase;
+	ktime_t edge;
+
+	if (!fsin->gpio || fsin->running)
+		return 0;
+
+	mutex_lock(&sensor_fsin_lock);
+
+	if (!sensor_fsin_users) {
+		/* A pair checked by the parameter setters */
+		kernel_param_lock(THIS_MODULE);
+		rate = rate_hz;
+		pulse = pulse_us;
+		kernel_param_unlock(THIS_MODULE);
+
+		if (!rate) {
+			mutex_unlock(&sensor_fsin_lock);
+			return 0;
+		}
+
+		period = div_u64(NSEC_PER_SEC, rate);
+		sensor_fsin_period = ns_to_ktime(period);
+		sensor_fsin_width = ns_to_ktime((u64)pulse * NSEC_PER_USEC);
+		sensor_fsin_epoch = ktime_get();
+	}
+	if (gpiod_cansleep(fsin->gpio)) {
+		mutex_unlock(&sensor_fsin_lock);
+		dev_warn(fsin->dev, "FSIN GPIO can sleep, no FSIN pulses\n");
+		return -EOPNOTSUPP;
+	}
+	sensor_fsin_users++;
+
+	fsin->period = sensor_fsin_period;
+	fsin->width = sensor_fsin_width;
+	div64_u64_rem(fsin->phase_ns, ktime_to_ns(fsin->period), &phase);
+	edge = ktime_add_ns(sensor_fsin_epoch, phase);
+
+	mutex_unlock(&sensor_fsin_lock);
+
+	fsin->high = false;
+	fsin->next = sensor_fsin_next_edge(fsin, edge, ktime_get());
+	fsin->running = true;
+
+	dev_dbg(fsin->dev, "FSIN %lld ns period, %llu ns phase\n",
+		ktime_to_ns(fsin->period), phase);
+
+	hrtimer_start(&fsin->timer, fsin->next, HRTIMER_MODE_ABS);
+
+	return 0;
+}
+EXPORT_SYMBOL_GPL(sensor_fsin_start);
+
+/* Stop pulsing and leave FSIN low */
+void sensor_fsin_stop(struct sensor_fsin *fsin)
+{
+	if (!fsin->running)
+		return;
+
+	hrtimer_cancel(&fsin->timer);
+	gpiod_set_value(fsin->gpio, 0);
+	fsin->high = false;
+	fsin->running = false;
+
+	mutex_lock(&sensor_fsin_lock);
+	sensor_fsin_users--;
+	mutex_unlock(&sensor_fsin_lock);
+}
+EXPORT_SYMBOL_GPL(sensor_fsin_stop);
+
+MODULE_DESCRIPTION("Camera sensor FSIN pulse generator");
+MODULE_LICENSE("GPL");
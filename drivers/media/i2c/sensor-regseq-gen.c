@@ -0,0 +1,495 @@
+// SPDX-License-Identifier: GPL-2.0
+// Copyright (c) 2025 Intel Corporation.
+/*
+ * Compile a sensor register description (.regs) into the packed blobs
+ * executed by sensor_regseq_write_blob().
+ *
+ * Input, one statement per line, '#' starts a comment:
+ *
+ *   table <name>		start a register table
+ *     w8 <addr> <val>		8-bit register write
+ *     w16 <addr> <val>		16-bit register write
+ *     delay <ms>		sleep
+ *     poll8 <addr> <val>	wait until the register reads val
+ *     poll16 <addr> <val>
+ *   end
+ *   deltas <name> <table>...	mode switch blobs between each pair of tables
+ *   nomerge <addr>...		registers written one at a time
+ *
+ * Writes to contiguous addresses are merged into WRITE segments of up to
+ * BURST_MAX bytes, so the driver issues each segment as one I2C burst.
+ * Registers listed by nomerge, such as data ports that do not advance the
+ * address within a burst, always get a WRITE segment of their own.
+ *
+ * A delta from table A to table B holds the entries of B whose final
+ * value differs from A. Registers B writes more than once are kept as a
+ * whole, as are delays and polls. When A writes a register B does not
+ * touch there is no delta and the matrix entry is NULL. Writes to nomerge
+ * registers have side effects and are always kept.
+ *
+ * Usage: sensor-regseq-gen <file.regs> > <file-regs.h>
+ */
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Keep in sync with include/media/sensor-regseq.h */
+#define BURST_MAX		32
+#define OP_END			0x00
+#define OP_WRITE		0x01
+#define OP_DELAY		0x02
+#define OP_POLL8		0x03
+#define OP_POLL16		0x04
+
+#define MAX_NAME		64
+/* Room left in MAX_NAME for the "_<from>_<to>" suffix of delta blobs */
+#define MAX_DELTAS_NAME		40
+#define MAX_LINE		256
+
+enum entry_type { E_W8, E_W16, E_DELAY, E_POLL8, E_POLL16 };
+
+struct entry {
+	enum entry_type type;
+	unsigned int addr;
+	unsigned int val;
+};
+
+struct table {
+	char name[MAX_NAME];
+	struct entry *entries;
+	unsigned int num;
+};
+
+struct deltas {
+	char name[MAX_NAME];
+	unsigned int *tables;
+	unsigned int num;
+};
+
+static const char *input;
+static unsigned int lineno;
+
+static struct table *tables;
+static unsigned int num_tables;
+static struct deltas *deltas;
+static unsigned int num_deltas;
+static unsigned int *nomerge;
+static unsigned int num_nomerge;
+
+static void die(const char *fmt, ...)
+{
+	va_list ap;
+
+	fprintf(stderr, "%s:%u: ", input, lineno);
+	va_start(ap, fmt);
+	vfprintf(stderr, fmt, ap);
+	va_end(ap);
+	fputc('\n', stderr);
+	exit(1);
+}
+
+static void *xrealloc(void *p, size_t size)
+{
+	p = realloc(p, size);
+	if (!p) {
+		perror("realloc");
+		exit(1);
+	}
+
+	return p;
+}
+
+static unsigned int parse_num(const char *tok, unsigned int max)
+{
+	unsigned long v;
+	char *end;
+
+	if (!tok)
+		die("missing operand");
+
+	errno = 0;
+	v = strtoul(tok, &end, 0);
+	if (errno || *end || v > max)
+		die("bad number '%s'", tok);
+
+	return v;
+}
+
+static void parse_name(char *dst, const char *tok)
+{
+	const char *p;
+
+	if (!tok || !*tok || strlen(tok) >= MAX_NAME)
+		die("bad name");
+
+	for (p = tok; *p; p++)
+		if (!isalnum((unsigned char)*p) && *p != '_')
+			die("bad name '%s'", tok);
+
+	strcpy(dst, tok);
+}
+
+static int find_table(const char *name)
+{
+	unsigned int i;
+
+	for (i = 0; i < num_tables; i++)
+		if (!strcmp(tables[i].name, name))
+			return i;
+
+	return -1;
+}
+
+static int is_nomerge(unsigned int addr)
+{
+	unsigned int i;
+
+	for (i = 0; i < num_nomerge; i++)
+		if (nomerge[i] == addr)
+			return 1;
+
+	return 0;
+}
+
+static void add_entry(struct table *t, enum entry_type type,
+		      unsigned int addr, unsigned int val)
+{
+	t->entries = xrealloc(t->entries, (t->num + 1) * sizeof(*t->entries));
+	t->entries[t->num].type = type;
+	t->entries[t->num].addr = addr;
+	t->entries[t->num].val = val;
+	t->num++;
+}
+
+static void parse(FILE *f)
+{
+	struct table *cur = NULL;
+	char line[MAX_LINE];
+	char *tok, *p;
+
+	while (fgets(line, sizeof(line), f)) {
+		lineno++;
+
+		p = strchr(line, '#');
+		if (p)
+			*p = '\0';
+
+		tok = strtok(line, " \t\r\n");
+		if (!tok)
+			continue;
+
+		if (!strcmp(tok, "table")) {
+			if (cur)
+				die("nested table");
+			tables = xrealloc(tables,
+					  (num_tables + 1) * sizeof(*tables));
+			cur = &tables[num_tables];
+			memset(cur, 0, sizeof(*cur));
+			parse_name(cur->name, strtok(NULL, " \t\r\n"));
+			if (find_table(cur->name) >= 0)
+				die("duplicate table '%s'", cur->name);
+			num_tables++;
+		} else if (!strcmp(tok, "end")) {
+			if (!cur)
+				die("'end' outside of a table");
+			cur = NULL;
+		} else if (!strcmp(tok, "deltas")) {
+			struct deltas *d;
+			int idx;
+
+			if (cur)
+				die("'deltas' inside a table");
+			deltas = xrealloc(deltas,
+					  (num_deltas + 1) * sizeof(*deltas));
+			d = &deltas[num_deltas++];
+			memset(d, 0, sizeof(*d));
+			parse_name(d->name, strtok(NULL, " \t\r\n"));
+			if (strlen(d->name) > MAX_DELTAS_NAME)
+				die("deltas name '%s' too long", d->name);
+			while ((tok = strtok(NULL, " \t\r\n"))) {
+				idx = find_table(tok);
+				if (idx < 0)
+					die("unknown table '%s'", tok);
+				d->tables = xrealloc(d->tables, (d->num + 1) *
+						     sizeof(*d->tables));
+				d->tables[d->num++] = idx;
+			}
+			if (!d->num)
+				die("'deltas' needs at least one table");
+		} else if (!strcmp(tok, "nomerge")) {
+			if (cur)
+				die("'nomerge' inside a table");
+			tok = strtok(NULL, " \t\r\n");
+			if (!tok)
+				die("missing operand");
+			do {
+				nomerge = xrealloc(nomerge, (num_nomerge + 1) *
+						   sizeof(*nomerge));
+				nomerge[num_nomerge++] = parse_num(tok, 0xffff);
+			} while ((tok = strtok(NULL, " \t\r\n")));
+		} else {
+			unsigned int addr = 0, val;
+			enum entry_type type;
+
+			if (!cur)
+				die("'%s' outside of a table", tok);
+
+			if (!strcmp(tok, "w8"))
+				type = E_W8;
+			else if (!strcmp(tok, "w16"))
+				type = E_W16;
+			else if (!strcmp(tok, "delay"))
+				type = E_DELAY;
+			else if (!strcmp(tok, "poll8"))
+				type = E_POLL8;
+			else if (!strcmp(tok, "poll16"))
+				type = E_POLL16;
+			else
+				die("unknown statement '%s'", tok);
+
+			if (type != E_DELAY)
+				addr = parse_num(strtok(NULL, " \t\r\n"),
+						 0xffff);
+			val = parse_num(strtok(NULL, " \t\r\n"),
+					type == E_W8 || type == E_POLL8 ?
+					0xff : 0xffff);
+			if (strtok(NULL, " \t\r\n"))
+				die("trailing operand");
+
+			add_entry(cur, type, addr, val);
+		}
+	}
+
+	if (cur)
+		die("table '%s' not terminated", cur->name);
+}
+
+static unsigned int entry_len(const struct entry *e)
+{
+	return e->type == E_W16 ? 2 : 1;
+}
+
+static int is_write(const struct entry *e)
+{
+	return e->type == E_W8 || e->type == E_W16;
+}
+
+static const struct entry *last_write(const struct table *t,
+				      unsigned int addr, unsigned int *count)
+{
+	const struct entry *found = NULL;
+	unsigned int i;
+
+	*count = 0;
+	for (i = 0; i < t->num; i++) {
+		if (is_write(&t->entries[i]) && t->entries[i].addr == addr) {
+			found = &t->entries[i];
+			(*count)++;
+		}
+	}
+
+	return found;
+}
+
+/* Build the delta from @a to @b into @out; 0 if there is none */
+static int build_delta(const struct table *a, const struct table *b,
+		       struct table *out)
+{
+	const struct entry *prev;
+	unsigned int i, count, writes;
+
+	memset(out, 0, sizeof(*out));
+
+	for (i = 0; i < a->num; i++)
+		if (is_write(&a->entries[i]) &&
+		    !last_write(b, a->entries[i].addr, &count))
+			return 0;
+
+	for (i = 0; i < b->num; i++) {
+		const struct entry *e = &b->entries[i];
+
+		if (is_write(e)) {
+			last_write(b, e->addr, &writes);
+			prev = last_write(a, e->addr, &count);
+			if (writes == 1 && prev && prev->type == e->type &&
+			    prev->val == e->val && !is_nomerge(e->addr))
+				continue;
+		}
+
+		add_entry(out, e->type, e->addr, e->val);
+	}
+
+	return 1;
+}
+
+static void emit_bytes(const unsigned char *buf, unsigned int len,
+		       const char *comment)
+{
+	unsigned int i;
+
+	printf("\t/* %s */\n\t", comment);
+	for (i = 0; i < len; i++)
+		printf("0x%02x,%s", buf[i],
+		       i + 1 == len ? "\n" : (i % 12 == 11 ? "\n\t" : " "));
+}
+
+static void emit_blob(const struct table *t)
+{
+	unsigned char buf[4 + BURST_MAX];
+	char comment[64];
+	unsigned int i, n, len, start;
+
+	printf("static const u8 %s_data[] = {\n", t->name);
+
+	for (i = 0; i < t->num; i += n) {
+		const struct entry *e = &t->entries[i];
+
+		n = 1;
+		switch (e->type) {
+		case E_DELAY:
+			buf[0] = OP_DELAY;
+			buf[1] = e->val >> 8;
+			buf[2] = e->val;
+			snprintf(comment, sizeof(comment), "delay %u ms",
+				 e->val);
+			emit_bytes(buf, 3, comment);
+			continue;
+		case E_POLL8:
+		case E_POLL16:
+			buf[0] = e->type == E_POLL8 ? OP_POLL8 : OP_POLL16;
+			buf[1] = e->addr >> 8;
+			buf[2] = e->addr;
+			if (e->type == E_POLL8) {
+				buf[3] = e->val;
+				len = 4;
+			} else {
+				buf[3] = e->val >> 8;
+				buf[4] = e->val;
+				len = 5;
+			}
+			snprintf(comment, sizeof(comment),
+				 "poll 0x%04x == 0x%x", e->addr, e->val);
+			emit_bytes(buf, len, comment);
+			continue;
+		default:
+			break;
+		}
+
+		start = e->addr;
+		for (n = 0, len = 0; i + n < t->num; n++) {
+			e = &t->entries[i + n];
+
+			if (!is_write(e) || e->addr != start + len ||
+			    len + entry_len(e) > BURST_MAX ||
+			    (n && (is_nomerge(start) || is_nomerge(e->addr))))
+				break;
+
+			if (e->type == E_W16) {
+				buf[4 + len] = e->val >> 8;
+				buf[5 + len] = e->val;
+			} else {
+				buf[4 + len] = e->val;
+			}
+			len += entry_len(e);
+		}
+
+		buf[0] = OP_WRITE;
+		buf[1] = start >> 8;
+		buf[2] = start;
+		buf[3] = len;
+		snprintf(comment, sizeof(comment), "0x%04x, %u byte%s", start,
+			 len, len == 1 ? "" : "s");
+		emit_bytes(buf, 4 + len, comment);
+	}
+
+	printf("\t/* end */\n\t0x%02x,\n};\n\n", OP_END);
+
+	printf("static const struct sensor_blob %s = {\n", t->name);
+	printf("\t.name = \"%s\",\n", t->name);
+	printf("\t.data = %s_data,\n", t->name);
+	printf("\t.size = sizeof(%s_data),\n", t->name);
+	printf("};\n\n");
+}
+
+static void emit_deltas(const struct deltas *d)
+{
+	struct table delta;
+	unsigned int i, j;
+	char *exists;
+
+	exists = calloc(d->num * d->num, 1);
+	if (!exists) {
+		perror("calloc");
+		exit(1);
+	}
+
+	for (i = 0; i < d->num; i++) {
+		for (j = 0; j < d->num; j++) {
+			if (i == j)
+				continue;
+
+			if (!build_delta(&tables[d->tables[i]],
+					 &tables[d->tables[j]], &delta))
+				continue;
+
+			snprintf(delta.name, sizeof(delta.name), "%.*s_%u_%u",
+				 MAX_DELTAS_NAME, d->name, i, j);
+			printf("/* %s -> %s */\n", tables[d->tables[i]].name,
+			       tables[d->tables[j]].name);
+			emit_blob(&delta);
+			free(delta.entries);
+			exists[i * d->num + j] = 1;
+		}
+	}
+
+	printf("static const struct sensor_blob *const %s[%u][%u] = {\n",
+	       d->name, d->num, d->num);
+	for (i = 0; i < d->num; i++) {
+		printf("\t{");
+		for (j = 0; j < d->num; j++) {
+			if (exists[i * d->num + j])
+				printf(" &%s_%u_%u,", d->name, i, j);
+			else
+				printf(" NULL,");
+		}
+		printf(" },\n");
+	}
+	printf("};\n\n");
+
+	free(exists);
+}
+
+int main(int argc, char **argv)
+{
+	unsigned int i;
+	FILE *f;
+
+	if (argc != 2) {
+		fprintf(stderr, "usage: %s <file.regs>\n", argv[0]);
+		return 1;
+	}
+
+	input = argv[1];
+	f = fopen(input, "r");
+	if (!f) {
+		perror(input);
+		return 1;
+	}
+	parse(f);
+	fclose(f);
+
+	printf("/* SPDX-License-Identifier: GPL-2.0 */\n");
+	printf("/* Generated by sensor-regseq-gen, do not edit. */\n\n");
+
+	for (i = 0; i < num_tables; i++)
+		emit_blob(&tables[i]);
+
+	for (i = 0; i < num_deltas; i++)
+		emit_deltas(&deltas[i]);
+
+	return 0;
+}
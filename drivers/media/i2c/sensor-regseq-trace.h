@@ -0,0 +1,83 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+/* Copyright (c) 2025 Intel Corporation. */
+
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM sensor_regseq
+
+#if !defined(__SENSOR_REGSEQ_TRACE_H) || defined(TRACE_HEADER_MULTI_READ)
+#define __SENSOR_REGSEQ_TRACE_H
+
+#include <linux/device.h>
+#include <linux/tracepoint.h>
+#include <linux/version.h>
+
+/*
+ * __assign_str() lost its source argument in 6.10, the source is now
+ * taken from the matching __string() field.
+ */
+#if LINUX_VERSION_CODE < KERNEL_VERSION(6, 10, 0)
+#define sensor_regseq_assign_str(dst, src)	__assign_str(dst, src)
+#else
+#define sensor_regseq_assign_str(dst, src)	__assign_str(dst)
+#endif
+
+/* One step of a stream-on, resume or mode switch sequence */
+TRACE_EVENT(sensor_regseq_step,
+	TP_PROTO(struct device *dev, const char *step, u64 duration_us,
+		 int ret),
+	TP_ARGS(dev, step, duration_us, ret),
+
+	TP_STRUCT__entry(
+		__string(dev, dev_name(dev))
+		__string(step, step)
+		__field(u64, duration_us)
+		__field(int, ret)
+	),
+
+	TP_fast_assign(
+		sensor_regseq_assign_str(dev, dev_name(dev));
+		sensor_regseq_assign_str(step, step);
+		__entry->duration_us = duration_us;
+		__entry->ret = ret;
+	),
+
+	TP_printk("%s %s %llu us ret=%d", __get_str(dev), __get_str(step),
+		  __entry->duration_us, __entry->ret)
+);
+
+/* One register blob written by sensor_regseq_write_blob() */
+TRACE_EVENT(sensor_regseq_blob,
+	TP_PROTO(struct device *dev, const char *blob, u32 bursts, u32 bytes,
+		 u64 duration_us, int ret),
+	TP_ARGS(dev, blob, bursts, bytes, duration_us, ret),
+
+	TP_STRUCT__entry(
+		__string(dev, dev_name(dev))
+		__string(blob, blob)
+		__field(u32, bursts)
+		__field(u32, bytes)
+		__field(u64, duration_us)
+		__field(int, ret)
+	),
+
+	TP_fast_assign(
+		sensor_regseq_assign_str(dev, dev_name(dev));
+		sensor_regseq_assign_str(blob, blob);
+		__entry->bursts = bursts;
+		__entry->bytes = bytes;
+		__entry->duration_us = duration_us;
+		__entry->ret = ret;
+	),
+
+	TP_printk("%s %s %u bursts %u bytes %llu us ret=%d", __get_str(dev),
+		  __get_str(blob), __entry->bursts, __entry->bytes,
+		  __entry->duration_us, __entry->ret)
+);
+
+#endif /* __SENSOR_REGSEQ_TRACE_H */
+
+#undef TRACE_INCLUDE_PATH
+#define TRACE_INCLUDE_PATH .
+#undef TRACE_INCLUDE_FILE
+#define TRACE_INCLUDE_FILE sensor-regseq-trace
+#include <trace/define_trace.h>
@@ -0,0 +1,785 @@
+// SPDX-License-Identifier: GPL-2.0
+// Copyright (c) 2025 Intel Corporation.
+
+#include <linux/debugfs.h>
+#include <linux/delay.h>
+#include <linux/iopoll.h>
+#include <linux/ktime.h>
+#include <linux/log2.h>
+#include <linux/module.h>
+#include <linux/regmap.h>
+#include <linux/seq_file.h>
+#include <linux/spinlock.h>
+#include <linux/swab.h>
+#include <linux/version.h>
+#if LINUX_VERSION_CODE < KERNEL_VERSION(6, 12, 0)
+#include <asm/unaligned.h>
+#else
+#include <linux/unaligned.h>
+#endif
+#include <media/v4l2-cci.h>
+
+#include "media/sensor-regseq.h"
+
+#define CREATE_TRACE_POINTS
+#include "sensor-regseq-trace.h"
+
+/* Defaults for SENSOR_BLOB_POLL* opcodes */
+#define SENSOR_REGSEQ_POLL_US		1000
+#define SENSOR_REGSEQ_POLL_TIMEOUT_US	100000
+
+struct sensor_regseq_retry {
+	struct sensor_regseq *seq;
+	const struct sensor_regseq_retry_policy *policy;
+	enum sensor_regseq_io op;
+	ktime_t start;
+	unsigned int attempts;
+	unsigned int delay_us;
+};
+
+static const char * const sensor_regseq_phase_names[] = {
+	[SENSOR_REGSEQ_PHASE_OTHER]	= "other",
+	[SENSOR_REGSEQ_PHASE_PROBE]	= "probe",
+	[SENSOR_REGSEQ_PHASE_INIT]	= "init",
+	[SENSOR_REGSEQ_PHASE_MODE]	= "mode",
+	[SENSOR_REGSEQ_PHASE_STREAM_ON]	= "stream-on",
+	[SENSOR_REGSEQ_PHASE_CTRL]	= "ctrl",
+	[SENSOR_REGSEQ_PHASE_RESUME]	= "resume",
+};
+
+static const char * const sensor_regseq_io_names[] = {
+	[SENSOR_REGSEQ_IO_READ]		= "read",
+	[SENSOR_REGSEQ_IO_WRITE]	= "write",
+};
+
+static struct dentry *sensor_regseq_debugfs_root;
+
+/*
+ * Called from probe, so bus accounting starts in the probe phase. Drivers
+ * switch to SENSOR_REGSEQ_PHASE_OTHER once probe is done.
+ */
+void sensor_regseq_init(struct sensor_regseq *seq, struct device *dev,
+			struct regmap *regmap)
+{
+	memset(seq, 0, sizeof(*seq));
+	seq->dev = dev;
+	seq->regmap = regmap;
+	seq->poll_us = SENSOR_REGSEQ_POLL_US;
+	seq->poll_timeout_us = SENSOR_REGSEQ_POLL_TIMEOUT_US;
+	seq->phase = SENSOR_REGSEQ_PHASE_PROBE;
+	spin_lock_init(&seq->lock);
+}
+EXPORT_SYMBOL_GPL(sensor_regseq_init);
+
+static void sensor_regseq_account_io(struct sensor_regseq *seq,
+				     enum sensor_regseq_io op, ktime_t start,
+				     size_t bytes, int ret)
+{
+	u64 us = ktime_us_delta(ktime_get(), start);
+	struct sensor_regseq_io_stats *io;
+	unsigned int bucket = 0;
+
+	if (us)
+		bucket = min_t(unsigned int, ilog2(us) + 1,
+			       SENSOR_REGSEQ_HIST_BUCKETS - 1);
+
+	spin_lock(&seq->lock);
+	io = &seq->io[seq->phase][op];
+	io->count++;
+	if (ret)
+		io->errors++;
+	else
+		io->bytes += bytes;
+	io->total_us += us;
+	io->hist[bucket]++;
+	spin_unlock(&seq->lock);
+}
+
+/*
+ * Single bus transactions, each one accounted in the current phase. The
+ * CCI_REG*() width and byte order are handled here rather than through
+ * cci_read()/cci_write(), which log every failed transfer: a booting or
+ * busy sensor NAKs on purpose, and the retry and poll loops report once
+ * when they give up.
+ */
+static u64 sensor_regseq_cci_decode(u32 reg, const u8 *buf, unsigned int len)
+{
+	u64 val = 0;
+	unsigned int i;
+
+	for (i = 0; i < len; i++)
+		val = val << 8 | buf[i];
+
+#ifdef CCI_REG_LE
+	if (reg & CCI_REG_LE)
+		val = swab64(val) >> (64 - len * 8);
+#endif
+
+	return val;
+}
+
+static void sensor_regseq_cci_encode(u32 reg, u64 val, u8 *buf,
+				     unsigned int len)
+{
+	unsigned int i;
+
+#ifdef CCI_REG_LE
+	if (reg & CCI_REG_LE)
+		val = swab64(val) >> (64 - len * 8);
+#endif
+
+	for (i = len; i--; val >>= 8)
+		buf[i] = val & 0xff;
+}
+
+static int sensor_regseq_bus_read(struct sensor_regseq *seq, u32 reg,
+				  u64 *val)
+{
+	unsigned int len = CCI_REG_WIDTH_BYTES(reg);
+	ktime_t start = ktime_get();
+	u8 buf[8];
+	int ret;
+
+	ret = regmap_bulk_read(seq->regmap, CCI_REG_ADDR(reg), buf, len);
+	sensor_regseq_account_io(seq, SENSOR_REGSEQ_IO_READ, start, len, ret);
+	if (!ret)
+		*val = sensor_regseq_cci_decode(reg, buf, len);
+
+	return ret;
+}
+
+static int sensor_regseq_bus_write(struct sensor_regseq *seq, u32 reg,
+				   u64 val)
+{
+	unsigned int len = CCI_REG_WIDTH_BYTES(reg);
+	ktime_t start = ktime_get();
+	u8 buf[8];
+	int ret;
+
+	sensor_regseq_cci_encode(reg, val, buf, len);
+	ret = regmap_bulk_write(seq->regmap, CCI_REG_ADDR(reg), buf, len);
+	sensor_regseq_account_io(seq, SENSOR_REGSEQ_IO_WRITE, start, len, ret);
+
+	return ret;
+}
+
+/*
+ * Read @len bytes from the bus in as few transactions as the adapter
+ * allows, accounting each one. With the regcache bypassed regmap reads
+ * cached ranges from the bus too, instead of register by register from
+ * the cache.
+ */
+static int sensor_regseq_bus_raw_read(struct sensor_regseq *seq, u16 reg,
+				      u8 *vals, unsigned int len)
+{
+	size_t max = regmap_get_raw_read_max(seq->regmap);
+	unsigned int n;
+	ktime_t start;
+	int ret;
+
+	for (; len; reg += n, vals += n, len -= n) {
+		n = max ? min_t(size_t, len, max) : len;
+		start = ktime_get();
+		ret = regmap_raw_read(seq->regmap, reg, vals, n);
+		sensor_regseq_account_io(seq, SENSOR_REGSEQ_IO_READ, start, n,
+					 ret);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
+static int sensor_regseq_bus_bulk_write(struct sensor_regseq *seq, u16 reg,
+					const u8 *vals, unsigned int len)
+{
+	ktime_t start = ktime_get();
+	int ret;
+
+	ret = regmap_bulk_write(seq->regmap, reg, vals, len);
+	sensor_regseq_account_io(seq, SENSOR_REGSEQ_IO_WRITE, start, len, ret);
+
+	return ret;
+}
+
+static void sensor_regseq_retry_begin(struct sensor_regseq_retry *r,
+				      struct sensor_regseq *seq,
+				      enum sensor_regseq_io op,
+				      const struct sensor_regseq_retry_policy *policy)
+{
+	r->seq = seq;
+	r->policy = policy;
+	r->op = op;
+	r->start = ktime_get();
+	r->attempts = 1;
+	r->delay_us = policy ? policy->min_us : 0;
+}
+
+/* Sleep before the next attempt; false once the budget is spent */
+static bool sensor_regseq_retry_next(struct sensor_regseq_retry *r)
+{
+	struct sensor_regseq *seq = r->seq;
+	s64 elapsed;
+
+	if (!r->policy)
+		return false;
+
+	elapsed = ktime_us_delta(ktime_get(), r->start);
+	if (elapsed >= r->policy->timeout_us)
+		return false;
+
+	fsleep(min_t(s64, r->delay_us, r->policy->timeout_us - elapsed));
+	r->delay_us = min(r->delay_us * 2, r->policy->max_us);
+	r->attempts++;
+
+	spin_lock(&seq->lock);
+	seq->io[seq->phase][r->op].retries++;
+	spin_unlock(&seq->lock);
+
+	return true;
+}
+
+static void sensor_regseq_retry_end(struct sensor_regseq_retry *r, int ret)
+{
+	struct sensor_regseq *seq = r->seq;
+	struct sensor_regseq_retry_stats *stats = &seq->retry_stats;
+	s64 elapsed;
+
+	if (r->attempts == 1)
+		return;
+
+	elapsed = ktime_us_delta(ktime_get(), r->start);
+
+	spin_lock(&seq->lock);
+	stats->retried++;
+	stats->wait_us += elapsed;
+	stats->max_attempts = max(stats->max_attempts, r->attempts);
+	if (ret)
+		stats->failed++;
+	spin_unlock(&seq->lock);
+
+	dev_dbg(seq->dev, "%s after %u attempts in %lld us\n",
+		ret ? "Register access failed" : "Register access recovered",
+		r->attempts, elapsed);
+}
+
+/*
+ * Check whether the regcache already holds @val for @reg, without going
+ * to the bus. Volatile and not yet cached registers never match, and so
+ * does everything on a regmap without a cache.
+ */
+bool sensor_regseq_cached(struct sensor_regseq *seq, unsigned int reg,
+			  unsigned int val)
+{
+	unsigned int cur;
+
+	if (!regcache_reg_cached(seq->regmap, reg))
+		return false;
+
+	if (regmap_read(seq->regmap, reg, &cur))
+		return false;
+
+	return cur == val;
+}
+EXPORT_SYMBOL_GPL(sensor_regseq_cached);
+
+/* Read a CCI_REG*() register, retrying according to @policy if given */
+int sensor_regseq_read(struct sensor_regseq *seq, u32 reg, u64 *val,
+		       const struct sensor_regseq_retry_policy *policy)
+{
+	struct sensor_regseq_retry r;
+	int ret;
+
+	sensor_regseq_retry_begin(&r, seq, SENSOR_REGSEQ_IO_READ, policy);
+	do {
+		ret = sensor_regseq_bus_read(seq, reg, val);
+	} while (ret && sensor_regseq_retry_next(&r));
+	sensor_regseq_retry_end(&r, ret);
+
+	if (ret)
+		dev_err_ratelimited(seq->dev,
+				    "read reg failed (addr=0x%04lx, attempts=%u, err=%d)\n",
+				    CCI_REG_ADDR(reg), r.attempts, ret);
+
+	return ret;
+}
+EXPORT_SYMBOL_GPL(sensor_regseq_read);
+
+/*
+ * Write a CCI_REG*() register, retrying according to @policy if given.
+ * 8-bit writes of the value already in the regcache are skipped.
+ */
+int sensor_regseq_write(struct sensor_regseq *seq, u32 reg, u64 val,
+			const struct sensor_regseq_retry_policy *policy)
+{
+	struct sensor_regseq_retry r;
+	int ret;
+
+	if (CCI_REG_WIDTH_BYTES(reg) == 1 &&
+	    sensor_regseq_cached(seq, CCI_REG_ADDR(reg), val))
+		return 0;
+
+	sensor_regseq_retry_begin(&r, seq, SENSOR_REGSEQ_IO_WRITE, policy);
+	do {
+		ret = sensor_regseq_bus_write(seq, reg, val);
+	} while (ret && sensor_regseq_retry_next(&r));
+	sensor_regseq_retry_end(&r, ret);
+
+	if (ret)
+		dev_err_ratelimited(seq->dev,
+				    "write reg failed (addr=0x%04lx, attempts=%u, err=%d)\n",
+				    CCI_REG_ADDR(reg), r.attempts, ret);
+
+	return ret;
+}
+EXPORT_SYMBOL_GPL(sensor_regseq_write);
+
+/* Write @len raw bytes to @reg in one transaction, e.g. to a data port */
+int sensor_regseq_raw_write(struct sensor_regseq *seq, unsigned int reg,
+			    const void *val, size_t len)
+{
+	ktime_t start = ktime_get();
+	int ret;
+
+	ret = regmap_raw_write(seq->regmap, reg, val, len);
+	sensor_regseq_account_io(seq, SENSOR_REGSEQ_IO_WRITE, start, len, ret);
+
+	return ret;
+}
+EXPORT_SYMBOL_GPL(sensor_regseq_raw_write);
+
+/*
+ * Poll a CCI_REG*() register until it reads @val. Nothing is logged, the
+ * caller reports a failure once. Returns the last bus error if the sensor
+ * never answered in time, -ETIMEDOUT if it kept reading another value.
+ */
+int sensor_regseq_poll(struct sensor_regseq *seq, u32 reg, u64 val,
+		       unsigned int sleep_us, unsigned int timeout_us)
+{
+	u64 cur = 0;
+	int ret, err;
+
+	/* Keep polling through NAKs, the sensor may be busy switching */
+	err = read_poll_timeout(sensor_regseq_bus_read, ret,
+				!ret && cur == val, sleep_us, timeout_us,
+				false, seq, reg, &cur);
+
+	return err && ret ? ret : err;
+}
+EXPORT_SYMBOL_GPL(sensor_regseq_poll);
+
+static int sensor_regseq_write_burst(struct sensor_regseq *seq, u16 reg,
+				     const u8 *vals, unsigned int len,
+				     const struct sensor_regseq_retry_policy *policy)
+{
+	struct sensor_regseq_retry r;
+	int ret;
+
+	sensor_regseq_retry_begin(&r, seq, SENSOR_REGSEQ_IO_WRITE, policy);
+	do {
+		ret = sensor_regseq_bus_bulk_write(seq, reg, vals, len);
+	} while (ret && sensor_regseq_retry_next(&r));
+	sensor_regseq_retry_end(&r, ret);
+
+	return ret;
+}
+
+/*
+ * Emit a sensor_regseq_step trace event for @step of a driver sequence,
+ * which started at @start and completed with @ret.
+ */
+void sensor_regseq_trace_step(struct sensor_regseq *seq, const char *step,
+			      ktime_t start, int ret)
+{
+	if (trace_sensor_regseq_step_enabled())
+		trace_sensor_regseq_step(seq->dev, step,
+					 ktime_us_delta(ktime_get(), start),
+					 ret);
+}
+EXPORT_SYMBOL_GPL(sensor_regseq_trace_step);
+
+/* Called with the lock held, NULL if the table is full */
+static struct sensor_regseq_stats *
+sensor_regseq_get_stats(struct sensor_regseq *seq,
+			const struct sensor_blob *blob)
+{
+	unsigned int i;
+
+	for (i = 0; i < seq->nr_stats; i++)
+		if (seq->stats[i].blob == blob)
+			return &seq->stats[i];
+
+	if (seq->nr_stats == seq->max_stats)
+		return NULL;
+
+	seq->stats[seq->nr_stats].blob = blob;
+
+	return &seq->stats[seq->nr_stats++];
+}
+
+/* Double the blob statistics table, keeping what was collected so far */
+static void sensor_regseq_grow_stats(struct sensor_regseq *seq)
+{
+	struct sensor_regseq_stats *stats, *old;
+	unsigned int max;
+
+	max = max_t(unsigned int, seq->max_stats * 2, SENSOR_REGSEQ_MIN_STATS);
+	stats = devm_kcalloc(seq->dev, max, sizeof(*stats), GFP_KERNEL);
+	if (!stats)
+		return;
+
+	spin_lock(&seq->lock);
+	if (seq->max_stats >= max) {
+		/* Grown meanwhile */
+		spin_unlock(&seq->lock);
+		devm_kfree(seq->dev, stats);
+		return;
+	}
+	old = seq->stats;
+	if (old)
+		memcpy(stats, old, seq->nr_stats * sizeof(*stats));
+	seq->stats = stats;
+	seq->max_stats = max;
+	spin_unlock(&seq->lock);
+
+	if (old)
+		devm_kfree(seq->dev, old);
+}
+
+static void sensor_regseq_account(struct sensor_regseq *seq,
+				  const struct sensor_blob *blob,
+				  ktime_t start, u32 bursts, u32 bytes, int ret)
+{
+	u32 elapsed = ktime_us_delta(ktime_get(), start);
+	struct sensor_regseq_stats *stats;
+
+	spin_lock(&seq->lock);
+	stats = sensor_regseq_get_stats(seq, blob);
+	if (!stats) {
+		spin_unlock(&seq->lock);
+		sensor_regseq_grow_stats(seq);
+		spin_lock(&seq->lock);
+		stats = sensor_regseq_get_stats(seq, blob);
+	}
+	if (stats) {
+		stats->count++;
+		if (ret)
+			stats->errors++;
+		stats->last_us = elapsed;
+		stats->max_us = max(stats->max_us, elapsed);
+		stats->total_us += elapsed;
+		stats->bursts = bursts;
+		stats->bytes = bytes;
+	}
+	spin_unlock(&seq->lock);
+
+	if (!stats)
+		dev_warn_once(seq->dev, "no memory for %s statistics, dropped\n",
+			      blob->name);
+
+	trace_sensor_regseq_blob(seq->dev, blob->name, bursts, bytes, elapsed,
+				 ret);
+}
+
+/*
+ * Write one WRITE segment as a single auto-increment burst, trimmed to
+ * the bytes that differ from the regcache. A fully cached segment is not
+ * written at all. Returns the number of bytes sent or a negative error.
+ */
+static int sensor_regseq_write_segment(struct sensor_regseq *seq, u16 start,
+				       const u8 *vals, unsigned int len,
+				       const struct sensor_regseq_retry_policy *policy)
+{
+	unsigned int first, last;
+	int ret;
+
+	for (first = 0; first < len; first++)
+		if (!sensor_regseq_cached(seq, start + first, vals[first]))
+			break;
+	if (first == len)
+		return 0;
+
+	for (last = len; last > first + 1; last--)
+		if (!sensor_regseq_cached(seq, start + last - 1, vals[last - 1]))
+			break;
+
+	ret = sensor_regseq_write_burst(seq, start + first, vals + first,
+					last - first, policy);
+	if (ret) {
+		dev_err_ratelimited(seq->dev,
+				    "write reg failed (addr=0x%04x, len=%u, err=%d)\n",
+				    start + first, last - first, ret);
+		return ret;
+	}
+
+	return last - first;
+}
+
+/*
+ * Execute a register blob compiled by sensor-regseq-gen. The blob is
+ * already split into burst-ready WRITE segments, so this only walks the
+ * opcodes. Each segment is retried according to @policy if given.
+ */
+int sensor_regseq_write_blob(struct sensor_regseq *seq,
+			     const struct sensor_blob *blob,
+			     const struct sensor_regseq_retry_policy *policy)
+{
+	const u8 *p = blob->data, *end = blob->data + blob->size;
+	ktime_t start_time = ktime_get();
+	u32 bursts = 0, bytes = 0;
+	unsigned int len;
+	u16 addr, val;
+	int ret = 0;
+
+	while (p < end && *p != SENSOR_BLOB_END) {
+		switch (*p) {
+		case SENSOR_BLOB_WRITE:
+			addr = get_unaligned_be16(p + 1);
+			len = p[3];
+			ret = sensor_regseq_write_segment(seq, addr, p + 4, len,
+							  policy);
+			if (ret < 0)
+				goto out;
+			if (ret) {
+				bursts++;
+				bytes += ret;
+			}
+			p += 4 + len;
+			break;
+		case SENSOR_BLOB_DELAY:
+			msleep(get_unaligned_be16(p + 1));
+			p += 3;
+			break;
+		case SENSOR_BLOB_POLL8:
+		case SENSOR_BLOB_POLL16:
+			addr = get_unaligned_be16(p + 1);
+			if (*p == SENSOR_BLOB_POLL8) {
+				val = p[3];
+				ret = sensor_regseq_poll(seq, CCI_REG8(addr), val,
+							 seq->poll_us,
+							 seq->poll_timeout_us);
+				p += 4;
+			} else {
+				val = get_unaligned_be16(p + 3);
+				ret = sensor_regseq_poll(seq, CCI_REG16(addr), val,
+							 seq->poll_us,
+							 seq->poll_timeout_us);
+				p += 5;
+			}
+			if (ret) {
+				dev_err(seq->dev,
+					"poll reg 0x%04x for 0x%04x failed: %d\n",
+					addr, val, ret);
+				goto out;
+			}
+			break;
+		default:
+			dev_err(seq->dev, "%s: bad opcode 0x%02x at %td\n",
+				blob->name, *p, p - blob->data);
+			ret = -EINVAL;
+			goto out;
+		}
+	}
+
+	ret = 0;
+out:
+	sensor_regseq_account(seq, blob, start_time, bursts, bytes, ret);
+
+	return ret;
+}
+EXPORT_SYMBOL_GPL(sensor_regseq_write_blob);
+
+/*
+ * Check whether the sensor holds every value @blob writes, e.g. to adopt
+ * a sensor left configured by a previous kernel. Delays and polls are
+ * ignored. The regcache is bypassed, so every segment is read from the
+ * sensor, in one transaction unless the adapter limits the read length,
+ * and the cache is left as it was. The caller must keep other register
+ * access away meanwhile.
+ *
+ * Returns 1 if all values match, 0 if one differs, or a negative error.
+ */
+int sensor_regseq_verify_blob(struct sensor_regseq *seq,
+			      const struct sensor_blob *blob)
+{
+	const u8 *p = blob->data, *end = blob->data + blob->size;
+	u8 buf[SENSOR_REGSEQ_BURST_MAX];
+	unsigned int len;
+	u16 addr;
+	int ret;
+
+	regcache_cache_bypass(seq->regmap, true);
+
+	while (p < end && *p != SENSOR_BLOB_END) {
+		switch (*p) {
+		case SENSOR_BLOB_WRITE:
+			addr = get_unaligned_be16(p + 1);
+			len = p[3];
+			if (len > sizeof(buf)) {
+				ret = -EINVAL;
+				goto out;
+			}
+
+			ret = sensor_regseq_bus_raw_read(seq, addr, buf, len);
+			if (ret)
+				goto out;
+
+			if (memcmp(buf, p + 4, len)) {
+				dev_dbg(seq->dev, "%s: mismatch in 0x%04x..0x%04x\n",
+					blob->name, addr, addr + len - 1);
+				ret = 0;
+				goto out;
+			}
+			p += 4 + len;
+			break;
+		case SENSOR_BLOB_DELAY:
+			p += 3;
+			break;
+		case SENSOR_BLOB_POLL8:
+			p += 4;
+			break;
+		case SENSOR_BLOB_POLL16:
+			p += 5;
+			break;
+		default:
+			dev_err(seq->dev, "%s: bad opcode 0x%02x at %td\n",
+				blob->name, *p, p - blob->data);
+			ret = -EINVAL;
+			goto out;
+		}
+	}
+
+	ret = 1;
+out:
+	regcache_cache_bypass(seq->regmap, false);
+
+	return ret;
+}
+EXPORT_SYMBOL_GPL(sensor_regseq_verify_blob);
+
+static int sensor_regseq_io_show(struct seq_file *m, void *data)
+{
+	struct sensor_regseq *seq = m->private;
+	const struct sensor_regseq_io_stats *io;
+	unsigned int phase, op, i;
+
+	seq_puts(m, "# phase op count errors retries bytes total_us hist[<1us 1us 2us 4us ... >=16ms]\n");
+
+	spin_lock(&seq->lock);
+	for (phase = 0; phase < SENSOR_REGSEQ_NR_PHASES; phase++) {
+		for (op = 0; op < SENSOR_REGSEQ_NR_IO; op++) {
+			io = &seq->io[phase][op];
+			if (!io->count)
+				continue;
+
+			seq_printf(m, "%s %s %llu %llu %llu %llu %llu",
+				   sensor_regseq_phase_names[phase],
+				   sensor_regseq_io_names[op], io->count,
+				   io->errors, io->retries, io->bytes,
+				   io->total_us);
+			for (i = 0; i < SENSOR_REGSEQ_HIST_BUCKETS; i++)
+				seq_printf(m, " %u", io->hist[i]);
+			seq_putc(m, '\n');
+		}
+	}
+	spin_unlock(&seq->lock);
+
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(sensor_regseq_io);
+
+static int sensor_regseq_sequences_show(struct seq_file *m, void *data)
+{
+	struct sensor_regseq *seq = m->private;
+	const struct sensor_regseq_retry_stats *r = &seq->retry_stats;
+	const struct sensor_regseq_stats *stats;
+	unsigned int i;
+
+	seq_puts(m, "# name count errors last_us max_us total_us bursts bytes\n");
+
+	spin_lock(&seq->lock);
+	for (i = 0; i < seq->nr_stats; i++) {
+		stats = &seq->stats[i];
+		seq_printf(m, "%s %u %u %u %u %llu %u %u\n", stats->blob->name,
+			   stats->count, stats->errors, stats->last_us,
+			   stats->max_us, stats->total_us, stats->bursts,
+			   stats->bytes);
+	}
+	seq_printf(m, "# retried %u failed %u max_attempts %u wait_us %llu\n",
+		   r->retried, r->failed, r->max_attempts, r->wait_us);
+	spin_unlock(&seq->lock);
+
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(sensor_regseq_sequences);
+
+static ssize_t sensor_regseq_reset_write(struct file *file,
+					 const char __user *buf, size_t count,
+					 loff_t *ppos)
+{
+	struct sensor_regseq *seq = file->private_data;
+
+	spin_lock(&seq->lock);
+	memset(&seq->retry_stats, 0, sizeof(seq->retry_stats));
+	if (seq->stats)
+		memset(seq->stats, 0, seq->max_stats * sizeof(*seq->stats));
+	seq->nr_stats = 0;
+	memset(seq->io, 0, sizeof(seq->io));
+	spin_unlock(&seq->lock);
+
+	return count;
+}
+
+static const struct file_operations sensor_regseq_reset_fops = {
+	.owner = THIS_MODULE,
+	.open = simple_open,
+	.write = sensor_regseq_reset_write,
+	.llseek = noop_llseek,
+};
+
+static void sensor_regseq_debugfs_remove(void *data)
+{
+	struct sensor_regseq *seq = data;
+
+	debugfs_remove_recursive(seq->debugfs);
+	seq->debugfs = NULL;
+}
+
+/*
+ * Expose the bus statistics of @seq in debugfs, under
+ * sensor-regseq/<device>/. Removed automatically with the device.
+ */
+int sensor_regseq_debugfs_init(struct sensor_regseq *seq)
+{
+	seq->debugfs = debugfs_create_dir(dev_name(seq->dev),
+					  sensor_regseq_debugfs_root);
+
+	debugfs_create_file("io", 0444, seq->debugfs, seq,
+			    &sensor_regseq_io_fops);
+	debugfs_create_file("sequences", 0444, seq->debugfs, seq,
+			    &sensor_regseq_sequences_fops);
+	debugfs_create_file("reset", 0200, seq->debugfs, seq,
+			    &sensor_regseq_reset_fops);
+
+	return devm_add_action_or_reset(seq->dev, sensor_regseq_debugfs_remove,
+					seq);
+}
+EXPORT_SYMBOL_GPL(sensor_regseq_debugfs_init);
+
+static int __init sensor_regseq_module_init(void)
+{
+	sensor_regseq_debugfs_root = debugfs_create_dir("sensor-regseq", NULL);
+
+	return 0;
+}
+
+static void __exit sensor_regseq_module_exit(void)
+{
+	debugfs_remove_recursive(sensor_regseq_debugfs_root);
+}
+
+module_init(sensor_regseq_module_init);
+module_exit(sensor_regseq_module_exit);
+
+MODULE_DESCRIPTION("Camera sensor register sequence helpers");
+MODULE_LICENSE("GPL");
@@ -0,0 +1,58 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+/* Copyright (c) 2025 Intel Corporation. */
+
+#ifndef __SENSOR_FSIN_H
+#define __SENSOR_FSIN_H
+
+#include <linux/device.h>
+#include <linux/gpio/consumer.h>
+#include <linux/hrtimer.h>
+#include <linux/ktime.h>
+#include <linux/types.h>
+
+/*
+ * FSIN pulse generator of one sensor. All sensors of the host share the
+ * rate and a common time base, so their frames start together, shifted
+ * by each sensor's phase.
+ */
+struct sensor_fsin {
+	struct device *dev;
+	struct gpio_desc *gpio;		/* NULL if none */
+	struct hrtimer timer;
+
+	u64 phase_ns;			/* Delay of the edge after the time base */
+	ktime_t period;
+	ktime_t width;
+	ktime_t next;			/* Next rising edge */
+	bool high;
+	bool running;
+};
+
+#if IS_ENABLED(CONFIG_VIDEO_SENSOR_FSIN)
+int sensor_fsin_init(struct sensor_fsin *fsin, struct device *dev,
+		     struct gpio_desc *gpio);
+int sensor_fsin_start(struct sensor_fsin *fsin);
+void sensor_fsin_stop(struct sensor_fsin *fsin);
+#else
+static inline int sensor_fsin_init(struct sensor_fsin *fsin,
+				   struct device *dev,
+				   struct gpio_desc *gpio)
+{
+	fsin->dev = dev;
+	fsin->gpio = NULL;
+	fsin->running = false;
+
+	return 0;
+}
+
+static inline int sensor_fsin_start(struct sensor_fsin *fsin)
+{
+	return 0;
+}
+
+static inline void sensor_fsin_stop(struct sensor_fsin *fsin)
+{
+}
+#endif
+
+#endif /* __SENSOR_FSIN_H */
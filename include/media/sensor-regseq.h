@@ -0,0 +1,174 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+/* Copyright (c) 2025 Intel Corporation. */
+
+#ifndef __SENSOR_REGSEQ_H
+#define __SENSOR_REGSEQ_H
+
+#include <linux/device.h>
+#include <linux/ktime.h>
+#include <linux/regmap.h>
+#include <linux/spinlock.h>
+#include <linux/types.h>
+
+/* Max payload of one auto-increment burst write, see sensor-regseq-gen */
+#define SENSOR_REGSEQ_BURST_MAX		32
+
+/*
+ * Initial size of the per-sequence blob statistics, the table doubles
+ * whenever a driver writes more distinct blobs
+ */
+#define SENSOR_REGSEQ_MIN_STATS		16
+
+/*
+ * Bus latency histogram buckets: [0] < 1 us, [n] 2^(n-1)..2^n - 1 us,
+ * the last one collects everything from 16.4 ms up.
+ */
+#define SENSOR_REGSEQ_HIST_BUCKETS	16
+
+/*
+ * What the driver is doing when it touches the bus. Phases nest, the
+ * innermost one set with sensor_regseq_set_phase() gets the accounting.
+ */
+enum sensor_regseq_phase {
+	SENSOR_REGSEQ_PHASE_OTHER,
+	SENSOR_REGSEQ_PHASE_PROBE,
+	SENSOR_REGSEQ_PHASE_INIT,
+	SENSOR_REGSEQ_PHASE_MODE,
+	SENSOR_REGSEQ_PHASE_STREAM_ON,
+	SENSOR_REGSEQ_PHASE_CTRL,
+	SENSOR_REGSEQ_PHASE_RESUME,
+	SENSOR_REGSEQ_NR_PHASES,
+};
+
+enum sensor_regseq_io {
+	SENSOR_REGSEQ_IO_READ,
+	SENSOR_REGSEQ_IO_WRITE,
+	SENSOR_REGSEQ_NR_IO,
+};
+
+/*
+ * Register blob opcodes, as emitted by sensor-regseq-gen from the .regs
+ * tables. Operands are big endian and follow the opcode byte:
+ *
+ * WRITE	addr(2) len(1) data(len)	one auto-increment burst
+ * DELAY	ms(2)
+ * POLL8	addr(2) val(1)			wait until addr reads val
+ * POLL16	addr(2) val(2)
+ * END
+ */
+enum sensor_blob_op {
+	SENSOR_BLOB_END = 0x00,
+	SENSOR_BLOB_WRITE = 0x01,
+	SENSOR_BLOB_DELAY = 0x02,
+	SENSOR_BLOB_POLL8 = 0x03,
+	SENSOR_BLOB_POLL16 = 0x04,
+};
+
+struct sensor_blob {
+	const char *name;
+	const u8 *data;
+	u32 size;
+};
+
+/*
+ * Retry policy for register access while the sensor is booting or busy:
+ * back off exponentially from min_us to max_us until timeout_us expired.
+ */
+struct sensor_regseq_retry_policy {
+	unsigned int min_us;
+	unsigned int max_us;
+	unsigned int timeout_us;
+};
+
+struct sensor_regseq_retry_stats {
+	u32 retried;		/* Accesses that needed more than one attempt */
+	u32 failed;		/* Accesses that ran out of retry budget */
+	u32 max_attempts;	/* Worst number of attempts seen */
+	u64 wait_us;		/* Total time spent in retried accesses */
+};
+
+/* Bus transactions of one kind in one phase */
+struct sensor_regseq_io_stats {
+	u64 count;		/* Transactions, including retried attempts */
+	u64 errors;		/* Transactions that failed */
+	u64 retries;		/* Attempts beyond the first one */
+	u64 bytes;		/* Payload bytes moved */
+	u64 total_us;		/* Time spent on the bus */
+	u32 hist[SENSOR_REGSEQ_HIST_BUCKETS];
+};
+
+/* Timing of one register blob */
+struct sensor_regseq_stats {
+	const struct sensor_blob *blob;
+	u32 count;		/* Times the blob was written */
+	u32 errors;		/* Writes that failed */
+	u32 last_us;		/* Duration of the last write */
+	u32 max_us;		/* Worst duration seen */
+	u64 total_us;		/* Sum of all durations */
+	u32 bursts;		/* I2C writes issued by the last write */
+	u32 bytes;		/* Payload bytes sent by the last write */
+};
+
+struct sensor_regseq {
+	struct device *dev;
+	struct regmap *regmap;
+
+	/* Interval and budget for SENSOR_BLOB_POLL* opcodes */
+	unsigned int poll_us;
+	unsigned int poll_timeout_us;
+
+	enum sensor_regseq_phase phase;
+
+	/*
+	 * Protects the statistics below. Only bus traffic issued through
+	 * these helpers is accounted, regmap's own writes such as a
+	 * regcache_sync() are not, drivers restore registers with blobs.
+	 */
+	spinlock_t lock;
+	struct sensor_regseq_retry_stats retry_stats;
+	struct sensor_regseq_stats *stats;	/* devm allocated, may be NULL */
+	unsigned int nr_stats;
+	unsigned int max_stats;
+	struct sensor_regseq_io_stats io[SENSOR_REGSEQ_NR_PHASES][SENSOR_REGSEQ_NR_IO];
+
+	struct dentry *debugfs;
+};
+
+/* Enter @phase, returns the previous phase to restore on exit */
+static inline enum sensor_regseq_phase
+sensor_regseq_set_phase(struct sensor_regseq *seq,
+			enum sensor_regseq_phase phase)
+{
+	enum sensor_regseq_phase old = seq->phase;
+
+	seq->phase = phase;
+
+	return old;
+}
+
+void sensor_regseq_init(struct sensor_regseq *seq, struct device *dev,
+			struct regmap *regmap);
+int sensor_regseq_debugfs_init(struct sensor_regseq *seq);
+
+bool sensor_regseq_cached(struct sensor_regseq *seq, unsigned int reg,
+			  unsigned int val);
+
+int sensor_regseq_read(struct sensor_regseq *seq, u32 reg, u64 *val,
+		       const struct sensor_regseq_retry_policy *policy);
+int sensor_regseq_write(struct sensor_regseq *seq, u32 reg, u64 val,
+			const struct sensor_regseq_retry_policy *policy);
+int sensor_regseq_raw_write(struct sensor_regseq *seq, unsigned int reg,
+			    const void *val, size_t len);
+int sensor_regseq_poll(struct sensor_regseq *seq, u32 reg, u64 val,
+		       unsigned int sleep_us, unsigned int timeout_us);
+
+int sensor_regseq_write_blob(struct sensor_regseq *seq,
+			     const struct sensor_blob *blob,
+			     const struct sensor_regseq_retry_policy *policy);
+int sensor_regseq_verify_blob(struct sensor_regseq *seq,
+			      const struct sensor_blob *blob);
+
+void sensor_regseq_trace_step(struct sensor_regseq *seq, const char *step,
+			      ktime_t start, int ret);
+
+#endif /* __SENSOR_REGSEQ_H */